@@ -17,8 +17,10 @@
 #include <QTime>
 #include <QToolButton>
 #include <QAction>
+#include <QVector3D>
 
 class Keypoint;
+class KeypointStore;
 
 inline void delayl(int ms) {
 	//delay function that doesn't interrupt the QEventLoop
@@ -35,8 +37,11 @@ struct Frame {
 	QString imagePath;
 	QSize imageDimensions;
 	int numKeypoints;
-	QList<Keypoint*> keypoints;
-	QMap<QString, Keypoint*> keypointMap;
+	int imgSetIndex;
+	int frameIndex;
+	KeypointStore *keypointStore;
+	Keypoint keypoint(int id) const;
+	Keypoint keypoint(const QString& id) const;
 };
 
 struct ImgSet {
@@ -52,6 +57,11 @@ struct SkeletonComponent {
 };
 Q_DECLARE_METATYPE(SkeletonComponent)
 
+struct KeypointCoords3D {
+	QList<QVector3D> coords;		//indexed by keypointId
+	QList<bool> valid;
+};
+
 
 
 struct DatasetConfig {
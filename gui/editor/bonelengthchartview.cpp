@@ -30,6 +30,7 @@ void BoneLengthChartView::update(std::vector<double> *boneLengthErrors, int sele
 		return;
 	}
 	chart->removeAllSeries();
+	m_selectedIndex = selectedIndex;
 
 	if (selectedIndex != -1) {
 		chart->setTitle(Dataset::dataset->skeleton()[selectedIndex].name);
@@ -45,24 +46,16 @@ void BoneLengthChartView::update(std::vector<double> *boneLengthErrors, int sele
 
 		int count = 0;
 		m_barSeriesList.clear();
+		m_barSetList.clear();
 		for (const auto& error : *m_boneLengthErrors) {
 			double error_abs = std::abs(error);
 			QBarSeries *series = new QBarSeries();
 			m_barSeriesList.append(series);
 			connect(series, &QBarSeries::hovered, this, &BoneLengthChartView::onHoverSlot);
 			QBarSet * set = new QBarSet("Test");
-			if (error_abs >= m_errorThreshold && count != selectedIndex) {
-				set->setColor(QColor(100,32,164));
-				set->setBorderColor(QColor(100,32,164));
-			}
-			else if (count != selectedIndex) {
-				set->setColor(QColor(100,164,32));
-				set->setBorderColor(QColor(100,164,32));
-			}
-			else {
-				set->setColor(QColor(32,100,164));
-				set->setBorderColor(QColor(32,100,164));
-			}
+			m_barSetList.append(set);
+			set->setColor(barColor(error_abs, count));
+			set->setBorderColor(barColor(error_abs, count));
 			*set << error_abs;
 			series->append(set);
 			chart->addSeries(series);
@@ -73,6 +66,31 @@ void BoneLengthChartView::update(std::vector<double> *boneLengthErrors, int sele
 }
 
 
+//Changes height and color of a single bar instead of rebuilding all series
+void BoneLengthChartView::updateBar(int index) {
+	if (m_boneLengthErrors == nullptr || index < 0 || index >= m_barSetList.size() ||
+				m_barSetList.size() != static_cast<int>(m_boneLengthErrors->size())) {
+		update();
+		return;
+	}
+	const double error_abs = std::abs((*m_boneLengthErrors)[index]);
+	QBarSet *set = m_barSetList[index];
+	set->setColor(barColor(error_abs, index));
+	set->setBorderColor(barColor(error_abs, index));
+	set->replace(0, error_abs);
+	float maxValue = *std::max_element(m_boneLengthErrors->begin(), m_boneLengthErrors->end());
+	float minValue = *std::min_element(m_boneLengthErrors->begin(), m_boneLengthErrors->end());
+	axisY->setRange(0, std::max(-minValue, maxValue));
+}
+
+
+QColor BoneLengthChartView::barColor(double error, int index) const {
+	if (index == m_selectedIndex) return QColor(32,100,164);
+	if (error >= m_errorThreshold) return QColor(100,32,164);
+	return QColor(100,164,32);
+}
+
+
 void BoneLengthChartView::onHoverSlot() {
 	QBarSeries* series = qobject_cast<QBarSeries*>(QObject::sender());
 	int index = m_barSeriesList.indexOf(series);
@@ -27,12 +27,17 @@ class BoneLengthChartView : public QChartView {
 
 	public slots:
 		void update(std::vector<double> *boneLengthErrors = nullptr, int selectedIndex = -1);
+		void updateBar(int index);
 		void boneLengthErrorThresholdChangedSlot(double value);
 
 	private:
+		QColor barColor(double error, int index) const;
+
 		double m_errorThreshold = 10.0;
-		std::vector<double> *m_boneLengthErrors;
+		std::vector<double> *m_boneLengthErrors = nullptr;
+		int m_selectedIndex = -1;
 		QList<QBarSeries*> m_barSeriesList;
+		QList<QBarSet*> m_barSetList;
 
 		QChart *chart;
 		QValueAxis *axisY;
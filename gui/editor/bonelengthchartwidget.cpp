@@ -8,6 +8,7 @@
 	*****************************************************************/
 
 #include "bonelengthchartwidget.hpp"
+#include "profiler.hpp"
 
 #include <random>
 
@@ -48,7 +49,15 @@ void BoneLengthChartWidget::datasetLoadedSlot() {
 
 
 void BoneLengthChartWidget::boneLengthErrorsUpdatedSlot(QMap<QString, std::vector<double>*> boneLengthErrors) {
+	PROFILE_SCOPE("Bone length chart");
 	for (const auto& entity : boneLengthErrors.keys()) {
 		boneLengthChartViews[entity]->update(boneLengthErrors[entity]);
 	}
 }
+
+
+void BoneLengthChartWidget::boneLengthErrorChangedSlot(const QString& entity, int bone) {
+	PROFILE_SCOPE("Bone length chart");
+	BoneLengthChartView *chart = boneLengthChartViews.value(entity, nullptr);
+	if (chart != nullptr) chart->updateBar(bone);
+}
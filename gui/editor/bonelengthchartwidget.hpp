@@ -32,6 +32,7 @@ class BoneLengthChartWidget : public QWidget {
 	public slots:
 		void datasetLoadedSlot();
 		void boneLengthErrorsUpdatedSlot(QMap<QString, std::vector<double>*> boneLengthErrors);
+		void boneLengthErrorChangedSlot(const QString& entity, int bone);
 
 	private:
 		QTabWidget *chartsTabWidget;
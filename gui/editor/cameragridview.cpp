@@ -0,0 +1,194 @@
+/*******************************************************************************
+ * File:			  cameragridview.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "cameragridview.hpp"
+
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <cmath>
+
+
+CameraGridView::CameraGridView(QWidget *parent) : QWidget(parent) {
+	this->setMinimumSize(150,150);
+	connect(ImageCache::instance(), &ImageCache::previewDecoded,
+				this, &CameraGridView::previewDecodedSlot);
+}
+
+
+void CameraGridView::setImgSet(ImgSet *imgSet, int currentFrameIndex) {
+	m_imgSet = imgSet;
+	m_currentFrameIndex = currentFrameIndex;
+	const int numCameras = imgSet->frames.size();
+	if (numCameras == 0) return;
+	m_imgSetIndex = imgSet->frames[0]->imgSetIndex;
+	m_columns = static_cast<int>(std::ceil(std::sqrt(numCameras)));
+	m_rows = (numCameras + m_columns - 1)/m_columns;
+
+	//Previews that are already cached show up immediately, the others are
+	//decoded in parallel and arrive through previewDecodedSlot
+	ImageCache *cache = ImageCache::instance();
+	m_previews = QList<QImage>(numCameras);
+	m_imageSizes = QList<QSize>(numCameras);
+	QList<QString> missing;
+	for (int i = 0; i < numCameras; i++) {
+		QSize imageSize;
+		QImage image = cache->cachedPreview(imgSet->frames[i]->imagePath, &imageSize);
+		if (image.isNull()) {
+			missing.append(imgSet->frames[i]->imagePath);
+		}
+		else {
+			setPreview(i, image, imageSize);
+		}
+	}
+	cache->requestPreviews(missing);
+
+	KeypointStore *store = imgSet->frames[0]->keypointStore;
+	if (store != m_connectedStore) {
+		if (m_connectedStore != nullptr) {
+			disconnect(m_connectedStore, &KeypointStore::keypointChanged,
+						this, &CameraGridView::keypointChangedSlot);
+		}
+		m_connectedStore = store;
+		connect(m_connectedStore, &KeypointStore::keypointChanged,
+					this, &CameraGridView::keypointChangedSlot);
+	}
+	update();
+}
+
+
+void CameraGridView::frameChangedSlot(int imgSetIndex, int frameIndex) {
+	m_imgSetIndex = imgSetIndex;
+	m_currentFrameIndex = frameIndex;
+	if (!isVisible() || Dataset::dataset == nullptr) return;
+	setImgSet(Dataset::dataset->imgSets()[imgSetIndex], frameIndex);
+}
+
+
+void CameraGridView::showEvent(QShowEvent *event) {
+	QWidget::showEvent(event);
+	if (m_imgSetIndex >= 0 && Dataset::dataset != nullptr &&
+				m_imgSetIndex < Dataset::dataset->imgSets().size()) {
+		setImgSet(Dataset::dataset->imgSets()[m_imgSetIndex], m_currentFrameIndex);
+	}
+}
+
+
+void CameraGridView::setPreview(int frameIndex, const QImage& image,
+			const QSize& imageSize) {
+	//A full resolution image is only kept at preview size
+	QSize previewSize = imageSize/ImageCache::PreviewScaleDenominator;
+	if (image.width() > previewSize.width()*2) {
+		m_previews[frameIndex] = image.scaled(previewSize, Qt::IgnoreAspectRatio,
+					Qt::SmoothTransformation);
+	}
+	else {
+		m_previews[frameIndex] = image;
+	}
+	m_imageSizes[frameIndex] = imageSize;
+}
+
+
+void CameraGridView::previewDecodedSlot(const QString& path) {
+	if (m_imgSet == nullptr || !isVisible()) return;
+	for (int i = 0; i < m_imgSet->frames.size() && i < m_previews.size(); i++) {
+		if (m_imgSet->frames[i]->imagePath != path) continue;
+		QSize imageSize;
+		QImage image = ImageCache::instance()->cachedPreview(path, &imageSize);
+		if (!image.isNull()) {
+			setPreview(i, image, imageSize);
+			update(tileRect(i));
+		}
+	}
+}
+
+
+void CameraGridView::keypointChangedSlot(int imgSetIndex, int frameIndex, int) {
+	if (imgSetIndex == m_imgSetIndex && isVisible()) {
+		update(tileRect(frameIndex));
+	}
+}
+
+
+QRect CameraGridView::tileRect(int frameIndex) const {
+	const int cellWidth = width()/m_columns;
+	const int cellHeight = height()/m_rows;
+	QRect cell((frameIndex%m_columns)*cellWidth, (frameIndex/m_columns)*cellHeight,
+				cellWidth, cellHeight);
+	cell.adjust(2,2,-2,-2);
+	QSize imageSize;
+	if (frameIndex < m_imageSizes.size()) imageSize = m_imageSizes[frameIndex];
+	if (!imageSize.isValid() && m_imgSet != nullptr &&
+				frameIndex < m_imgSet->frames.size()) {
+		imageSize = m_imgSet->frames[frameIndex]->imageDimensions;
+	}
+	if (!imageSize.isValid() || imageSize.isEmpty()) return cell;
+	QSize tileSize = imageSize.scaled(cell.size(), Qt::KeepAspectRatio);
+	return QRect(cell.x() + (cell.width()-tileSize.width())/2,
+				cell.y() + (cell.height()-tileSize.height())/2,
+				tileSize.width(), tileSize.height());
+}
+
+
+void CameraGridView::paintEvent(QPaintEvent *event) {
+	QPainter p{this};
+	p.fillRect(rect(), QColor(34, 36, 40));
+	if (m_imgSet == nullptr) return;
+	p.setRenderHint(QPainter::SmoothPixmapTransform);
+	for (int i = 0; i < m_imgSet->frames.size() && i < m_previews.size(); i++) {
+		QRect tile = tileRect(i);
+		if (!tile.intersects(event->rect())) continue;
+		Frame *frame = m_imgSet->frames[i];
+		if (m_previews[i].isNull()) {
+			p.fillRect(tile, QColor(50, 52, 56));
+			p.setPen(QColor(150,150,150));
+			p.drawText(tile, Qt::AlignCenter, "Loading...");
+		}
+		else {
+			p.drawImage(tile, m_previews[i]);
+		}
+
+		QSize imageSize = m_imageSizes[i].isValid() ? m_imageSizes[i] :
+					frame->imageDimensions;
+		if (imageSize.isValid() && !imageSize.isEmpty()) {
+			const double scale = static_cast<double>(tile.width())/imageSize.width();
+			p.setPen(Qt::NoPen);
+			for (int k = 0; k < frame->numKeypoints; k++) {
+				Keypoint pt = frame->keypoint(k);
+				if (pt.state() != Annotated && pt.state() != Reprojected) continue;
+				QColor color = pt.color();
+				color.setAlpha(pt.state() == Reprojected ? 100 : 255);
+				p.setBrush(color);
+				p.drawEllipse(QPointF(tile.x() + pt.rx()*scale, tile.y() + pt.ry()*scale),
+							3.0, 3.0);
+			}
+		}
+
+		p.setBrush(Qt::NoBrush);
+		if (i == m_currentFrameIndex) {
+			p.setPen(QPen(QColor(100,164,32), 3));
+			p.drawRect(tile.adjusted(-1,-1,1,1));
+		}
+		if (Dataset::dataset != nullptr && i < Dataset::dataset->cameraNames().size()) {
+			p.setPen(QColor(255,255,255));
+			p.drawText(tile.adjusted(6,4,-6,-4), Qt::AlignLeft | Qt::AlignTop,
+						Dataset::dataset->cameraName(i));
+		}
+	}
+}
+
+
+void CameraGridView::mousePressEvent(QMouseEvent *event) {
+	if (m_imgSet == nullptr || event->button() != Qt::LeftButton) return;
+	for (int i = 0; i < m_imgSet->frames.size(); i++) {
+		if (tileRect(i).contains(event->pos())) {
+			emit cameraSelected(i);
+			return;
+		}
+	}
+}
@@ -0,0 +1,56 @@
+/*******************************************************************************
+ * File:			  cameragridview.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef CAMERAGRIDVIEW_H
+#define CAMERAGRIDVIEW_H
+
+#include "globals.hpp"
+#include "dataset.hpp"
+#include "imagecache.hpp"
+
+#include <QPainter>
+#include <QPointer>
+
+
+// Shows all cameras of an ImgSet side by side together with their keypoints.
+// The tiles are painted from the previews of the ImageCache, which are
+// decoded in parallel and shared with the ImageViewer, so promoting a tile
+// to the full viewer starts from an image that is already decoded.
+class CameraGridView : public QWidget {
+	Q_OBJECT
+	public:
+		explicit CameraGridView(QWidget *parent = nullptr);
+
+	signals:
+		void cameraSelected(int frameIndex);
+
+	public slots:
+		void setImgSet(ImgSet *imgSet, int currentFrameIndex);
+		void frameChangedSlot(int imgSetIndex, int frameIndex);
+		void previewDecodedSlot(const QString& path);
+		void keypointChangedSlot(int imgSetIndex, int frameIndex, int keypointId);
+
+	private:
+		QRect tileRect(int frameIndex) const;
+		void setPreview(int frameIndex, const QImage& image, const QSize& imageSize);
+		void paintEvent(QPaintEvent *) override;
+		void mousePressEvent(QMouseEvent *event) override;
+		void showEvent(QShowEvent *event) override;
+
+		ImgSet *m_imgSet = nullptr;
+		int m_imgSetIndex = -1;
+		int m_currentFrameIndex = 0;
+		int m_columns = 1;
+		int m_rows = 1;
+		QList<QImage> m_previews;
+		QList<QSize> m_imageSizes;
+		QPointer<KeypointStore> m_connectedStore;
+};
+
+#endif
@@ -132,13 +132,10 @@ void DatasetControlWidget::datasetLoadedSlot(QString selectedSegment) {
 
 void DatasetControlWidget::getAnnotationCounts(int frameIndex,
 			int &annotatedCount, int &totalCount) {
-	totalCount = Dataset::dataset->imgSets()[m_currentImgSetIndex]->
-							 frames[frameIndex]->keypoints.size();
-	annotatedCount = 0;
-	for (const auto & keypoint : Dataset::dataset->imgSets()[m_currentImgSetIndex]->
-															 frames[frameIndex]->keypoints) {
-		if (keypoint->state() !=  NotAnnotated) annotatedCount++;
-	}
+	KeypointStore *store = Dataset::dataset->keypointStore();
+	totalCount = store->numKeypoints();
+	annotatedCount = totalCount -
+				store->frameCount(m_currentImgSetIndex, frameIndex).notAnnotated;
 }
 
 
@@ -180,16 +177,10 @@ void DatasetControlWidget::frameChangedSlot(int imgSetIndex, int frameIndex) {
 }
 
 
-void DatasetControlWidget::keypointStateChangedSlot(KeypointState state,
-			KeypointState previousSate, int frameIndex) {
-	if (state == NotAnnotated) {
-		m_annotatedCounts[frameIndex]--;
-	}
-	else {
-		if (previousSate != Reprojected) {
-			m_annotatedCounts[frameIndex]++;
-		}
-	}
+void DatasetControlWidget::keypointStateChangedSlot(KeypointState,
+			KeypointState, int imgSetIndex, int frameIndex) {
+	if (imgSetIndex != m_currentImgSetIndex) return;
+	getAnnotationCounts(frameIndex, m_annotatedCounts[frameIndex], m_totalCount);
 	framesTable->item(frameIndex,1)->setText("("+ QString::number(m_annotatedCounts[frameIndex]) +
 				"/" + QString::number(m_totalCount) + ")");
 }
@@ -200,7 +191,6 @@ void DatasetControlWidget::imgSetChangedSlot() {
 }
 
 void DatasetControlWidget::segmentChangedSlot(const QString& segment) {
-	Dataset::dataset->save();
 	QList<QString> segmentNames = Dataset::dataset->segmentNames();
 	QList<QString> cameraNames = Dataset::dataset->cameraNames();
 	QList<SkeletonComponent> skeleton = Dataset::dataset->skeleton();
@@ -208,6 +198,8 @@ void DatasetControlWidget::segmentChangedSlot(const QString& segment) {
 	QString datasetBaseFolder = Dataset::dataset->datasetBaseFolder();
 	//datasetFolder = datasetFolder.remove(m_currentSegment);
 	datasetFolder = datasetBaseFolder +"/" + segment;
+	//Flushes the old segment and stops its writer, only one may own its files
+	delete Dataset::dataset;
 	Dataset::dataset = new Dataset(datasetFolder, datasetBaseFolder,
 	 								 		cameraNames, skeleton, segmentNames);
 	m_currentSegment = segment;
@@ -38,7 +38,7 @@ class DatasetControlWidget : public QWidget {
 		void datasetLoadedSlot(QString selectedSegment);
 		void frameChangedSlot(int imgSetIndex, int frameIndex);
 		void keypointStateChangedSlot(KeypointState state,
-					KeypointState previousSate, int frameIndex);
+					KeypointState previousSate, int imgSetIndex, int frameIndex);
 
 	private:
 		void getAnnotationCounts(int frameIndex, int &annotatedCount,
@@ -38,6 +38,10 @@ EditorWidget::EditorWidget(QWidget *parent) : QWidget(parent) {
 	imageViewer = new ImageViewer();
 	imageViewer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 	containerlayout->addWidget(imageViewer,0,0);
+	cameraGridView = new CameraGridView(imageViewerContainer);
+	cameraGridView->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+	cameraGridView->hide();
+	containerlayout->addWidget(cameraGridView,0,0);
 	//QImage img = QImage("../frame_25400.jpg");
 	//imageViewer->setImage(img);
 
@@ -86,6 +90,13 @@ EditorWidget::EditorWidget(QWidget *parent) : QWidget(parent) {
 	homeButton->setMaximumSize(130,35);
 	connect(homeButton, &QPushButton::clicked, this, &EditorWidget::homeClicked);
 	connect(homeButton, &QPushButton::clicked, this, &EditorWidget::homeClickedSlot);
+	gridButton = new QPushButton("Grid", buttonWidget);
+	gridButton->installEventFilter(this);
+	gridButton->setCheckable(true);
+	gridButton->setEnabled(false);
+	gridButton->setMinimumSize(130,35);
+	gridButton->setMaximumSize(130,35);
+	connect(gridButton, &QPushButton::toggled, this, &EditorWidget::gridToggledSlot);
 	QWidget *buttonSpacer2 = new QWidget(this);
 	buttonSpacer2->setMaximumSize(100,100);
 	buttonSpacer2->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -122,12 +133,13 @@ EditorWidget::EditorWidget(QWidget *parent) : QWidget(parent) {
 	buttonlayout->addWidget(cropButton,0,3);
 	buttonlayout->addWidget(panButton,0,4);
 	buttonlayout->addWidget(homeButton,0,5);
-	buttonlayout->addWidget(buttonSpacer2,0,6);
-	buttonlayout->addWidget(previousSetButton,0,7);
-	buttonlayout->addWidget(nextSetButton,0,8);
-	buttonlayout->addWidget(buttonSpacer3,0,9);
-	buttonlayout->addWidget(saveSetupButton,0,10);
-	buttonlayout->addWidget(show3DButton,0,11);
+	buttonlayout->addWidget(gridButton,0,6);
+	buttonlayout->addWidget(buttonSpacer2,0,7);
+	buttonlayout->addWidget(previousSetButton,0,8);
+	buttonlayout->addWidget(nextSetButton,0,9);
+	buttonlayout->addWidget(buttonSpacer3,0,10);
+	buttonlayout->addWidget(saveSetupButton,0,11);
+	buttonlayout->addWidget(show3DButton,0,12);
 
 	horizontalSplitter->addWidget(leftSplitter);
 	horizontalSplitter->addWidget(imageViewerContainer);
@@ -150,6 +162,7 @@ EditorWidget::EditorWidget(QWidget *parent) : QWidget(parent) {
 	connect(datasetControlWidget, &DatasetControlWidget::imgSetChanged, this, &EditorWidget::imgSetChangedSlot);
 	connect(datasetControlWidget, &DatasetControlWidget::datasetLoaded, this, &EditorWidget::datasetLoadedSlot);
 	connect(imageViewer, &ImageViewer::brightnessChanged, this, &EditorWidget::brightnessChanged);
+	connect(cameraGridView, &CameraGridView::cameraSelected, this, &EditorWidget::cameraSelectedSlot);
 
 
 	//<- Outgoing Signals
@@ -166,6 +179,7 @@ EditorWidget::EditorWidget(QWidget *parent) : QWidget(parent) {
 	connect(this, &EditorWidget::frameChanged, keypointWidget, &KeypointWidget::frameChangedSlot);
 	connect(this, &EditorWidget::frameChanged, reprojectionWidget, &ReprojectionWidget::calculateReprojectionSlot);
 	connect(this, &EditorWidget::frameChanged, datasetControlWidget, &DatasetControlWidget::frameChangedSlot);
+	connect(this, &EditorWidget::frameChanged, cameraGridView, &CameraGridView::frameChangedSlot);
 
 	//<-> Relayed Signals
 	connect(datasetControlWidget, &DatasetControlWidget::datasetLoaded, this, &EditorWidget::newSegmentLoaded);
@@ -177,14 +191,17 @@ EditorWidget::EditorWidget(QWidget *parent) : QWidget(parent) {
 	connect(imageViewer, &ImageViewer::keypointRemoved, keypointWidget, &KeypointWidget::keypointRemovedSlot);
 	connect(imageViewer, &ImageViewer::keypointCorrected, keypointWidget, &KeypointWidget::keypointCorrectedSlot);
 	connect(imageViewer, &ImageViewer::alreadyAnnotated, keypointWidget, &KeypointWidget::alreadyAnnotatedSlot);
-	connect(imageViewer, &ImageViewer::keypointChangedForReprojection, reprojectionWidget, &ReprojectionWidget::calculateReprojectionSlot);
+	connect(imageViewer, &ImageViewer::keypointChangedForReprojection, reprojectionWidget, &ReprojectionWidget::keypointChangedSlot);
 	connect(reprojectionWidget, &ReprojectionWidget::reprojectedPoints, keypointWidget, &KeypointWidget::setKeypointsFromDatasetSlot);
+	connect(reprojectionWidget, &ReprojectionWidget::reprojectedKeypoint, keypointWidget, &KeypointWidget::setKeypointFromDatasetSlot);
 	connect(reprojectionWidget, &ReprojectionWidget::reprojectionToolToggled, imageViewer, &ImageViewer::toggleReprojectionSlot);
 	connect(reprojectionWidget, &ReprojectionWidget::update3DCoords, visualizationWindow, &VisualizationWindow::update3DCoordsSlot);
+	connect(reprojectionWidget, &ReprojectionWidget::update3DCoord, visualizationWindow, &VisualizationWindow::update3DCoordSlot);
 	connect(reprojectionWidget, &ReprojectionWidget::reprojectionToolUpdated, visualizationWindow, &VisualizationWindow::reprojectionToolUpdatedSlot);
 	connect(this, &EditorWidget::minViewsChanged, reprojectionWidget, &ReprojectionWidget::minViewsChangedSlot);
 	connect(this, &EditorWidget::errorThresholdChanged, reprojectionWidget, &ReprojectionWidget::errorThresholdChanged);
 	connect(this, &EditorWidget::boneLengthErrorThresholdChanged, reprojectionWidget, &ReprojectionWidget::boneLengthErrorThresholdChanged);
+	connect(this, &EditorWidget::outlierThresholdChanged, reprojectionWidget, &ReprojectionWidget::outlierThresholdChangedSlot);
 }
 
 
@@ -369,6 +386,8 @@ void EditorWidget::datasetLoadedSlot(bool isSetupAnnotation, QString selectedSeg
 		saveSetupButton->hide();
 	}
 	keypointWidget->init();
+	gridButton->setChecked(false);
+	gridButton->setEnabled(true);
 	leftSplitter->show();
 	leftSplitter->setSizes({500,800});
 	keypointWidget->show();
@@ -376,6 +395,7 @@ void EditorWidget::datasetLoadedSlot(bool isSetupAnnotation, QString selectedSeg
 	m_currentImgSetIndex = 0;
 	m_currentFrameIndex = 0;
 	imageViewer->setFrame(m_currentImgSet, m_currentFrameIndex);
+	cameraGridView->frameChangedSlot(m_currentImgSetIndex, m_currentFrameIndex);
 
 	if (m_currentImgSet->numCameras != 1)
 	{
@@ -401,6 +421,29 @@ void EditorWidget::show3DClickedSlot() {
 	visualizationWindow->opened();
 }
 
+void EditorWidget::gridToggledSlot(bool toggle) {
+	if (toggle) {
+		cropButton->setChecked(false);
+		panButton->setChecked(false);
+		imageViewer->hide();
+		cameraGridView->show();
+	}
+	else {
+		cameraGridView->hide();
+		imageViewer->show();
+	}
+	cropButton->setEnabled(!toggle);
+	panButton->setEnabled(!toggle);
+	homeButton->setEnabled(!toggle);
+}
+
+
+void EditorWidget::cameraSelectedSlot(int frameIndex) {
+	gridButton->setChecked(false);
+	frameChangedSlot(frameIndex);
+}
+
+
 void EditorWidget::keyPressEvent(QKeyEvent *e)
 {
 	int key = e->key();
@@ -443,6 +486,9 @@ void EditorWidget::keyPressEvent(QKeyEvent *e)
 			previousSetClickedSlot();
 		}
 	}
+	else if (key == 71 && gridButton->isEnabled()) {
+		gridButton->toggle();
+	}
 	else if (key == 72) {
 		emit homeClicked();
 		homeClickedSlot();
@@ -13,6 +13,7 @@
 #include "globals.hpp"
 #include "keypointwidget.hpp"
 #include "imageviewer.hpp"
+#include "cameragridview.hpp"
 #include "reprojectionwidget.hpp"
 #include "datasetcontrolwidget.hpp"
 #include "visualizationwindow.hpp"
@@ -53,6 +54,7 @@ class EditorWidget : public QWidget {
 		void minViewsChanged(int val);
 		void errorThresholdChanged(float val);
 		void boneLengthErrorThresholdChanged(float val);
+		void outlierThresholdChanged(float val);
 		void brightnessChanged(int brightnessFactor);
 
 	public slots:
@@ -72,6 +74,7 @@ class EditorWidget : public QWidget {
 
 		QWidget *imageViewerContainer;
 		ImageViewer *imageViewer;
+		CameraGridView *cameraGridView;
 
 		VisualizationWindow *visualizationWindow;
 
@@ -82,6 +85,7 @@ class EditorWidget : public QWidget {
 		QPushButton *cropButton;
 		QPushButton *panButton;
 		QPushButton *homeButton;
+		QPushButton *gridButton;
 		QPushButton *previousSetButton;
 		QPushButton *nextSetButton;
 		QPushButton *saveSetupButton;
@@ -112,6 +116,8 @@ class EditorWidget : public QWidget {
 		void zoomFinishedSlot();
 		void panFinishedSlot();
 		void show3DClickedSlot();
+		void gridToggledSlot(bool toggle);
+		void cameraSelectedSlot(int frameIndex);
 };
 
 #endif
@@ -8,6 +8,7 @@
  	*****************************************************************/
 
 #include "imageviewer.hpp"
+#include "profiler.hpp"
 
 #include <QMouseEvent>
 #include <cmath>
@@ -23,14 +24,31 @@ void ImageViewer::fitToScreen() {
 
 
 void ImageViewer::setFrame(ImgSet *imgSet, int frameIndex) {
+	PROFILE_SCOPE("Navigation");
 	m_currentImgSet = imgSet;
 	m_currentFrameIndex = frameIndex;
-	m_img = QImage(m_currentImgSet->frames[m_currentFrameIndex]->imagePath);
-	m_imgOriginal = m_img;
-	if (m_hueFactor != 0 || m_saturationFactor != 100 || m_brightnessFactor != 100 || m_contrastFactor != 100) {
-		applyImageTransformations(m_hueFactor, m_saturationFactor, m_brightnessFactor, m_contrastFactor);
+	if (m_draggedPoint.isValid()) m_draggedPoint.commitCoordinates();
+	m_draggedPoint = Keypoint();
+	m_hoveredKeypointId = -1;
+	updateCurrentKeypointId();
+	m_currentImagePath = m_currentImgSet->frames[m_currentFrameIndex]->imagePath;
+	prefetchNeighbours();
+	//Frames that are not decoded yet are shown as a downscaled preview until
+	//the full image arrives in imageDecodedSlot
+	ImageCache *cache = ImageCache::instance();
+	QImage image = cache->cachedImage(m_currentImagePath);
+	m_showingPreview = image.isNull();
+	if (m_showingPreview) {
+		showImage(cache->preview(m_currentImagePath, &m_imageSize));
+		cache->requestImage(m_currentImagePath);
 	}
-	m_rect = m_img.rect();
+	else {
+		m_imageSize = image.size();
+		showImage(image);
+	}
+	rebuildKeypointGrid();
+	m_overlayDirty = true;
+	m_rect = QRect(QPoint(0,0), m_imageSize);
 	m_crop = m_rect;
 	m_rect.translate(-m_rect.center());
 	m_setImg = true;
@@ -38,6 +56,71 @@ void ImageViewer::setFrame(ImgSet *imgSet, int frameIndex) {
 }
 
 
+void ImageViewer::prefetchNeighbours() {
+	//Most likely next: the other cameras of this set, then the same camera
+	//followed by the others in the next and previous set
+	QList<QString> paths;
+	const int numCameras = m_currentImgSet->frames.size();
+	for (int i = 1; i < numCameras; i++) {
+		paths.append(m_currentImgSet->frames[(m_currentFrameIndex+i)%numCameras]->imagePath);
+	}
+	if (Dataset::dataset != nullptr && numCameras > 0) {
+		QList<ImgSet*> imgSets = Dataset::dataset->imgSets();
+		int imgSetIndex = m_currentImgSet->frames[0]->imgSetIndex;
+		for (int neighbour : {imgSetIndex+1, imgSetIndex-1}) {
+			if (neighbour < 0 || neighbour >= imgSets.size()) continue;
+			const QList<Frame*>& frames = imgSets[neighbour]->frames;
+			for (int i = 0; i < frames.size(); i++) {
+				paths.append(frames[(m_currentFrameIndex+i)%frames.size()]->imagePath);
+			}
+		}
+	}
+	ImageCache::instance()->prefetch(paths);
+}
+
+
+void ImageViewer::rebuildKeypointGrid() {
+	Frame *frame = m_currentImgSet->frames[m_currentFrameIndex];
+	if (frame->keypointStore != m_connectedStore) {
+		if (m_connectedStore != nullptr) {
+			disconnect(m_connectedStore, &KeypointStore::keypointChanged,
+						this, &ImageViewer::keypointChangedSlot);
+		}
+		m_connectedStore = frame->keypointStore;
+		m_keypointStylesDirty = true;
+		connect(m_connectedStore, &KeypointStore::keypointChanged,
+					this, &ImageViewer::keypointChangedSlot);
+	}
+	m_keypointGrid.build(frame->keypointStore, frame->imgSetIndex, frame->frameIndex,
+				m_imageSize, m_keypointSize*2.0f);
+}
+
+
+void ImageViewer::keypointChangedSlot(int imgSetIndex, int frameIndex,
+			int keypointId) {
+	if (m_keypointGrid.isBuiltFor(imgSetIndex, frameIndex)) {
+		m_keypointGrid.update(keypointId);
+		m_overlayDirty = true;
+	}
+}
+
+
+void ImageViewer::showImage(const QImage& image) {
+	m_imgOriginal = image;
+	m_meanBrightness = -1;
+	m_pyramid.setImage(m_imgOriginal, m_imageSize);
+	applyImageTransformations(m_hueFactor, m_saturationFactor, m_brightnessFactor, m_contrastFactor);
+}
+
+
+void ImageViewer::imageDecodedSlot(const QString& path) {
+	if (!m_showingPreview || path != m_currentImagePath) return;
+	m_showingPreview = false;
+	showImage(ImageCache::instance()->image(path));
+	update();
+}
+
+
 void ImageViewer::imageTransformationChangedSlot(int hueFactor, int saturationFactor,
 			int brightnessFactor, int contrastFactor) {
 	m_hueFactor = hueFactor;
@@ -50,16 +133,19 @@ void ImageViewer::imageTransformationChangedSlot(int hueFactor, int saturationFa
 
 void ImageViewer::alwaysShowLabelsToggledSlot(bool always_visible) {
 	m_labelAlwaysVisible = always_visible;
+	m_overlayDirty = true;
 	update();
 }
 
 void ImageViewer::labelFontColorChangedSlot(QColor color) {
 	m_labelFontColor = color;
+	m_overlayDirty = true;
 	update();
 }
 
 void ImageViewer::labelBackgroundColorChangedSlot(QColor color) {
 	m_labelBackgroundColor = color;
+	m_overlayDirty = true;
 	update();
 }
 
@@ -73,43 +159,59 @@ void ImageViewer::setBrightness(int brightnessFactor) {
 	ImageViewer::keypointSizeChangedSlot(int size)
 {
 	m_keypointSize = size;
+	m_overlayDirty = true;
+	if (m_setImg) rebuildKeypointGrid();
 	update();
 }
 
 void ImageViewer::applyImageTransformations(int hueFactor, int saturationFactor,
 			int brightnessFactor, int contrastFactor) {
-	int h,s,v;
-	long avg_brightness = 0;
-	double factor = contrastFactor/100.;
-	for (int i = 0; i < m_img.width(); i++) {
-		for (int j = 0; j < m_img.height(); j++) {
-			QColor color = m_imgOriginal.pixelColor(i,j);
-			color.getHsv(&h,&s,&v);
-			avg_brightness += v;
+	//Levels of the unadjusted pyramid are kept, only the ones that are painted
+	//get adjusted again, see adjustedLevel()
+	m_adjustment = ImageAdjustment(hueFactor, saturationFactor, brightnessFactor,
+				contrastFactor);
+	m_adjustedLevels.clear();
+}
+
+
+const QImage& ImageViewer::adjustedLevel(int level) {
+	if (m_adjustment.isIdentity()) return m_pyramid.level(level);
+	if (m_adjustedLevels.size() <= level) m_adjustedLevels.resize(level+1);
+	if (m_adjustedLevels[level].isNull()) {
+		PROFILE_SCOPE("Image adjustment");
+		//The mean only depends on the frame, not on the slider positions
+		if (m_meanBrightness < 0) {
+			m_meanBrightness = ImageAdjustment::meanBrightness(m_imgOriginal);
 		}
-	}
-	avg_brightness = avg_brightness/(m_img.width()*m_img.height());
-	for (int i = 0; i < m_img.width(); i++) {
-		for (int j = 0; j < m_img.height(); j++) {
-			QColor color = m_imgOriginal.pixelColor(i,j);
-			color.getHsv(&h,&s,&v);
-			v = (v-avg_brightness)*factor+ avg_brightness;
-			color.setHsv((h+hueFactor)%360,std::min(s*saturationFactor/100,255),
-									 std::max(0,std::min(v*brightnessFactor*brightnessFactor/10000,255)));
-			m_img.setPixelColor(i,j,color);
+		if (level == 0) {
+			//Slider moves reuse the buffer of the previous adjustment
+			m_adjustment.apply(m_imgOriginal, m_meanBrightness, &m_adjustedBuffer);
+			m_adjustedLevels[0] = m_adjustedBuffer.toImage();
+		}
+		else {
+			m_adjustedLevels[level] = m_adjustment.apply(m_pyramid.level(level),
+						m_meanBrightness);
 		}
 	}
+	return m_adjustedLevels[level];
 }
 
 
 void ImageViewer::paintEvent(QPaintEvent *) {
+	PROFILE_SCOPE("Viewer paint");
 	QPainter p{this};
 
 	p.translate(rect().center());
 	p.scale(m_scale, m_scale);
 	m_rect = m_crop;
 	m_rect.translate(-m_crop.center());
-	p.drawImage(m_rect, m_img, m_crop);
+	if (!m_pyramid.isNull()) {
+		//Paint from the level closest to the displayed size in device pixels
+		const int level = m_pyramid.levelForScale(m_scale*devicePixelRatioF());
+		p.setRenderHint(QPainter::SmoothPixmapTransform, m_scale < 1.0f);
+		p.drawImage(m_rect, adjustedLevel(level), m_pyramid.mapToLevel(m_crop, level));
+		p.setRenderHint(QPainter::SmoothPixmapTransform, false);
+	}
 
 	if(m_zoomStarted) {
 		QPointF rectImg = scaleToImageCoordinates(m_rectStart);
@@ -118,50 +220,86 @@ void ImageViewer::paintEvent(QPaintEvent *) {
 					rectImg.ry()-m_crop.center().ry()+m_crop.topLeft().ry()-m_heightOffset,
 					deltaImg.rx(),  deltaImg.ry());
 	}
-	for (auto& pt : m_currentImgSet->frames[m_currentFrameIndex]->keypoints) {
-		if (!hiddenEntityList.contains(pt->entity()) && (pt->state() == Annotated ||
-				pt->state() == Reprojected)) {
-			QPointF point = transformToImageCoordinates(pt->coordinates());
-			if (m_crop.contains(pt->coordinates())) {
-				QColor ptColor;
-				if (m_entityToColormapMap.contains(pt->entity())) {
-					ptColor = m_entityToColormapMap[pt->entity()]->
-										getColor(Dataset::dataset->bodypartsList().indexOf(pt->bodypart()),
-										Dataset::dataset->bodypartsList().size());
-				}
-				else {
-					ptColor = m_defaultColormap->getColor(Dataset::dataset->
-										bodypartsList().indexOf(pt->bodypart()),
-										Dataset::dataset->bodypartsList().size());
-				}
-				if (pt->state() == Reprojected) {
-					ptColor.setAlpha(100);
-				}
-				else if (pt->state() == Annotated) {
-					ptColor.setAlpha(255);
-				}
-				p.setBrush(ptColor);
-				p.setPen(QColor(0,0,0,0));
-				if(m_entityToKeypointShapeMap.contains(pt->entity())) {
-					if (m_entityToKeypointShapeMap[pt->entity()] == KeypointShape::Circle) {
-						p.drawEllipse(point,m_keypointSize/2.0,m_keypointSize/2.0);
-					}
-					else if (m_entityToKeypointShapeMap[pt->entity()] == KeypointShape::Rectangle) {
-						p.drawRect(QRectF(point.x()-m_keypointSize/2.0,
-											 point.y()-m_keypointSize/2.0,m_keypointSize,m_keypointSize));
-					}
-					else if(m_entityToKeypointShapeMap[pt->entity()] == KeypointShape::Triangle) {
-
-					}
-				}
-				else {
-					p.drawEllipse(point,m_keypointSize/2.0,m_keypointSize/2.0);
-				}
-				if (pt->showName() || m_labelAlwaysVisible) {
-					drawInfoBox(p,point, pt->entity(), pt->bodypart());
-				}
-				//pt->setShowName(false);
-			}
+	if (!m_setImg) return;
+	//Keypoints are painted into a cached layer that is only redrawn after edits,
+	//setting changes or when the view moves
+	if (m_overlayDirty || m_overlayCrop != m_crop || m_overlayScale != m_scale ||
+				m_overlay.deviceIndependentSize() != QSizeF(size())) {
+		renderOverlay();
+	}
+	p.save();
+	p.resetTransform();
+	p.drawImage(0, 0, m_overlay);
+	p.restore();
+
+	//The hover label is the only part that changes without an edit
+	if (m_hoveredKeypointId != -1 && !m_labelAlwaysVisible &&
+				m_hoveredKeypointId < m_keypointHidden.size()) {
+		Keypoint pt = m_currentImgSet->frames[m_currentFrameIndex]->keypoint(m_hoveredKeypointId);
+		if (!m_keypointHidden[pt.id()] && (pt.state() == Annotated ||
+					pt.state() == Reprojected) && m_crop.contains(pt.coordinates())) {
+			drawInfoBox(p, transformToImageCoordinates(pt.coordinates()), pt.entity(),
+						pt.bodypart());
+		}
+	}
+}
+
+
+void ImageViewer::updateKeypointStyles() {
+	KeypointStore *store = m_currentImgSet->frames[m_currentFrameIndex]->keypointStore;
+	m_keypointColors.clear();
+	m_keypointShapes.clear();
+	m_keypointHidden.clear();
+	const int numBodyparts = store->numBodyparts();
+	for (int keypointId = 0; keypointId < store->numKeypoints(); keypointId++) {
+		const QString& entity = store->entityName(store->entityIndex(keypointId));
+		ColorMap *colorMap = m_entityToColormapMap.value(entity, m_defaultColormap);
+		m_keypointColors.append(colorMap->getColor(store->bodypartIndex(keypointId),
+					numBodyparts));
+		m_keypointShapes.append(m_entityToKeypointShapeMap.value(entity,
+					KeypointShape::Circle));
+		m_keypointHidden.append(hiddenEntityList.contains(entity));
+	}
+	m_keypointStylesDirty = false;
+}
+
+
+void ImageViewer::renderOverlay() {
+	PROFILE_SCOPE("Overlay render");
+	if (m_keypointStylesDirty) updateKeypointStyles();
+	const qreal pixelRatio = devicePixelRatioF();
+	m_overlay = QImage(size()*pixelRatio, QImage::Format_ARGB32_Premultiplied);
+	m_overlay.setDevicePixelRatio(pixelRatio);
+	m_overlay.fill(Qt::transparent);
+	m_overlayCrop = m_crop;
+	m_overlayScale = m_scale;
+	m_overlayDirty = false;
+
+	QPainter p{&m_overlay};
+	p.translate(rect().center());
+	p.scale(m_scale, m_scale);
+	p.setPen(QColor(0,0,0,0));
+	Frame *frame = m_currentImgSet->frames[m_currentFrameIndex];
+	for (int i = 0; i < frame->numKeypoints; i++) {
+		Keypoint pt = frame->keypoint(i);
+		if (m_keypointHidden[i] || (pt.state() != Annotated &&
+				pt.state() != Reprojected) || !m_crop.contains(pt.coordinates())) {
+			continue;
+		}
+		QPointF point = transformToImageCoordinates(pt.coordinates());
+		QColor ptColor = m_keypointColors[i];
+		ptColor.setAlpha(pt.state() == Reprojected ? 100 : 255);
+		p.setBrush(ptColor);
+		if (m_keypointShapes[i] == KeypointShape::Circle) {
+			p.drawEllipse(point,m_keypointSize/2.0,m_keypointSize/2.0);
+		}
+		else if (m_keypointShapes[i] == KeypointShape::Rectangle) {
+			p.drawRect(QRectF(point.x()-m_keypointSize/2.0,
+								 point.y()-m_keypointSize/2.0,m_keypointSize,m_keypointSize));
+		}
+		if (m_labelAlwaysVisible) {
+			drawInfoBox(p,point, pt.entity(), pt.bodypart());
+			p.setPen(QColor(0,0,0,0));
 		}
 	}
 }
@@ -212,50 +350,45 @@ void ImageViewer::mousePressEvent(QMouseEvent *event) {
 	}
 	else if (event->button() == Qt::RightButton) {
 		if (hiddenEntityList.contains(m_currentEntity)) return;
-		Keypoint *keypoint = m_currentImgSet->frames[m_currentFrameIndex]->
-												 keypointMap[m_currentEntity + "/" + m_currentBodypart];
-		if(keypoint->state() == NotAnnotated) {
-			keypoint->setCoordinates(position);
-			keypoint->setState(Annotated);
+		Keypoint keypoint = m_currentImgSet->frames[m_currentFrameIndex]->
+												 keypoint(m_currentKeypointId);
+		if (!keypoint.isValid()) return;
+		if(keypoint.state() == NotAnnotated) {
+			keypoint.setCoordinates(position);
+			keypoint.setState(Annotated);
 			emit keypointAdded(keypoint);
-			emit keypointChangedForReprojection(Dataset::dataset->imgSets().indexOf(m_currentImgSet),
-																					m_currentFrameIndex);
+			emit keypointChangedForReprojection(keypoint.imgSetIndex(), m_currentFrameIndex,
+						keypoint.id());
 		}
 		else {
-			emit alreadyAnnotated(keypoint->state() == Suppressed);
+			emit alreadyAnnotated(keypoint.state() == Suppressed);
 		}
 		update();
 	}
 	else if (event->button() == Qt::MiddleButton) {
 		if (hiddenEntityList.contains(m_currentEntity)) return;
-		for (auto& pt : m_currentImgSet->frames[m_currentFrameIndex]->keypoints) {
-			double length = std::sqrt(std::pow((position-pt->coordinates()).x(), 2) + std::pow((position-pt->coordinates()).y(), 2));
-			if (length < m_keypointSize/2.0) {
-				if (pt->state() == Annotated || pt->state() == Reprojected) {
-					pt->setState(NotAnnotated);
-					emit keypointRemoved(pt);
-					emit keypointChangedForReprojection(Dataset::dataset->imgSets().indexOf(m_currentImgSet),
-																							m_currentFrameIndex);
-					update();
-					break;
-				}
-			}
+		int keypointId = m_keypointGrid.nearest(position, m_keypointSize/2.0f);
+		if (keypointId != -1) {
+			Keypoint pt = m_currentImgSet->frames[m_currentFrameIndex]->keypoint(keypointId);
+			pt.setState(NotAnnotated);
+			emit keypointRemoved(pt);
+			emit keypointChangedForReprojection(pt.imgSetIndex(), m_currentFrameIndex,
+						pt.id());
+			update();
 		}
 	}
 	else if (event->button() == Qt::LeftButton) {
 		if (hiddenEntityList.contains(m_currentEntity)) return;
-		for (auto& pt : m_currentImgSet->frames[m_currentFrameIndex]->keypoints) {
-			double length = std::sqrt(std::pow((position-pt->coordinates()).x(), 2) + std::pow((position-pt->coordinates()).y(), 2));
-			if (m_draggedPoint != pt && length < m_keypointSize/2.0 && (pt->state() == Annotated ||
-					pt->state() == Reprojected)) {
-				m_draggedPoint = pt;
-				pt->setState(Annotated);
-				emit keypointCorrected(pt);
-				m_dragReference = event->pos();
-				pt->setCoordinates(position);
-				update();
-				break;
-			}
+		int excludeId = m_draggedPoint.isValid() ? m_draggedPoint.id() : -1;
+		int keypointId = m_keypointGrid.nearest(position, m_keypointSize/2.0f, excludeId);
+		if (keypointId != -1) {
+			Keypoint pt = m_currentImgSet->frames[m_currentFrameIndex]->keypoint(keypointId);
+			m_draggedPoint = pt;
+			pt.setState(Annotated);
+			emit keypointCorrected(pt);
+			m_dragReference = event->pos();
+			pt.setCoordinates(position);
+			update();
 		}
 	}
 }
@@ -282,25 +415,24 @@ void ImageViewer::mouseMoveEvent(QMouseEvent *event) {
 										m_crop.topLeft().ry()-deltaImg.ry(), m_crop.width(), m_crop.height());
 		update();
 	}
-	if (m_draggedPoint == nullptr) {
+	if (!m_draggedPoint.isValid()) {
+		if (!m_setImg) return;
 		QPointF position = scaleToImageCoordinates(event->pos());
 		position = QPointF(m_crop.topLeft().rx()+position.rx()-m_widthOffset,
 											 m_crop.topLeft().ry()+position.ry()-m_heightOffset);
-		for (auto& pt : m_currentImgSet->frames[m_currentFrameIndex]->keypoints) {
-			float dist = std::sqrt(std::pow((position-pt->coordinates()).x(), 2) + std::pow((position-pt->coordinates()).y(), 2));
-			float prev_dist = std::sqrt(std::pow((m_previousPosition-pt->coordinates()).x(), 2) + std::pow((m_previousPosition-pt->coordinates()).y(), 2));
-			if ((dist < m_keypointSize/2.0 &&
-					prev_dist > m_keypointSize/2.0)) {
-				pt->setShowName(true);
-				for (auto& other_pt : m_currentImgSet->frames[m_currentFrameIndex]->keypoints) {
-					if (other_pt != pt) other_pt->setShowName(false);
-				}
-				update();
-				break;
-			}
-			else if (dist > m_keypointSize*2.0 &&
-							 prev_dist < m_keypointSize*2.0) {
-				pt->setShowName(false);
+		//A keypoint is hovered once the cursor is on it and stays hovered until
+		//the cursor is well outside of it again
+		int keypointId = m_keypointGrid.nearest(position, m_keypointSize/2.0f);
+		if (keypointId != -1 && keypointId != m_hoveredKeypointId) {
+			m_hoveredKeypointId = keypointId;
+			update();
+		}
+		else if (keypointId == -1 && m_hoveredKeypointId != -1) {
+			QPointF delta = position - m_currentImgSet->frames[m_currentFrameIndex]->
+						keypoint(m_hoveredKeypointId).coordinates();
+			if (delta.x()*delta.x() + delta.y()*delta.y() >
+						m_keypointSize*m_keypointSize*4.0) {
+				m_hoveredKeypointId = -1;
 				update();
 			}
 		}
@@ -310,7 +442,11 @@ void ImageViewer::mouseMoveEvent(QMouseEvent *event) {
 		m_dragDelta = (event->pos() - m_dragReference);
 		m_dragReference = event->pos();
 		QPointF deltaImg = scaleToImageCoordinates(m_dragDelta);
-		m_draggedPoint->setCoordinates(m_draggedPoint->coordinates()+deltaImg);
+		//Only the final position of a drag is saved, see mouseReleaseEvent
+		m_draggedPoint.setCoordinates(m_draggedPoint.coordinates()+deltaImg, true);
+		//Reprojections follow the dragged point, only its bodypart is updated
+		emit keypointChangedForReprojection(m_draggedPoint.imgSetIndex(),
+					m_currentFrameIndex, m_draggedPoint.id());
 		update();
 	}
 }
@@ -344,10 +480,11 @@ void ImageViewer::mouseReleaseEvent(QMouseEvent *event) {
 		update();
 		emit panFinished();
 	}
-	else if (event->button() == Qt::LeftButton && m_draggedPoint != nullptr) {
-		emit keypointChangedForReprojection(Dataset::dataset->imgSets().indexOf(m_currentImgSet),
-																				m_currentFrameIndex);
-		m_draggedPoint = nullptr;
+	else if (event->button() == Qt::LeftButton && m_draggedPoint.isValid()) {
+		m_draggedPoint.commitCoordinates();
+		emit keypointChangedForReprojection(m_draggedPoint.imgSetIndex(),
+																				m_currentFrameIndex, m_draggedPoint.id());
+		m_draggedPoint = Keypoint();
 	}
 }
 
@@ -394,7 +531,7 @@ void ImageViewer::panToggledSlot(bool toggle) {
 void ImageViewer::homeClickedSlot() {
 	m_zoomActive = false;
 	m_panActive = false;
-	m_crop = m_img.rect();
+	m_crop = QRect(QPoint(0,0), m_imageSize);
 	fitToScreen();
 	update();
 }
@@ -402,46 +539,66 @@ void ImageViewer::homeClickedSlot() {
 
 void ImageViewer::currentEntityChangedSlot(const QString& entity) {
 	m_currentEntity = entity;
+	updateCurrentKeypointId();
 }
 
 
 void ImageViewer::currentBodypartChangedSlot(const QString& bodypart, QColor color) {
 	m_currentBodypart = bodypart;
 	m_currentColor = color;
+	updateCurrentKeypointId();
+}
+
+
+void ImageViewer::updateCurrentKeypointId() {
+	m_currentKeypointId = -1;
+	if (Dataset::dataset == nullptr) return;
+	KeypointStore *store = Dataset::dataset->keypointStore();
+	if (store == nullptr) return;
+	m_currentKeypointId = store->keypointId(store->entityIndex(m_currentEntity),
+				store->bodypartIndex(m_currentBodypart));
 }
 
 
 void ImageViewer::toggleEntityVisibleSlot(const QString& entity, bool toggle) {
 	if (!toggle) {
 		hiddenEntityList.append(entity);
-		update();
 	}
 	else {
 		hiddenEntityList.removeAll(entity);
-		update();
 	}
+	m_keypointStylesDirty = true;
+	m_overlayDirty = true;
+	update();
 }
 
 
 void ImageViewer::toggleReprojectionSlot(bool toggle) {
 	Q_UNUSED(toggle);
+	m_overlayDirty = true;
 	update();
 }
 
 
 void ImageViewer::updateViewer() {
+	m_overlayDirty = true;
 	update();
 }
 
 
 void ImageViewer::keypointShapeChangedSlot(const QString& entity, KeypointShape shape) {
 	m_entityToKeypointShapeMap[entity] = shape;
+	m_keypointStylesDirty = true;
+	m_overlayDirty = true;
 	update();
 }
 
 
 void ImageViewer::colorMapChangedSlot(const QString& entity,
 				ColorMap::ColorMapType type, QColor color) {
+	delete m_entityToColormapMap.value(entity, nullptr);
 	m_entityToColormapMap[entity] = new ColorMap(type, color);
+	m_keypointStylesDirty = true;
+	m_overlayDirty = true;
 	update();
 }
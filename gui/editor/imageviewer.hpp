@@ -14,9 +14,14 @@
 #include "keypoint.hpp"
 #include "dataset.hpp"
 #include "colormap.hpp"
+#include "imagecache.hpp"
+#include "imageadjustment.hpp"
+#include "imagepyramid.hpp"
+#include "keypointgrid.hpp"
 
 
 #include <QPainter>
+#include <QPointer>
 
 
 class ImageViewer : public QWidget {
@@ -26,6 +31,12 @@ class ImageViewer : public QWidget {
 			this->setMinimumSize(150,150);
 			setMouseTracking(true);
 			m_defaultColormap = new ColorMap(ColorMap::Jet);
+			connect(ImageCache::instance(), &ImageCache::imageDecoded,
+						this, &ImageViewer::imageDecodedSlot);
+		}
+		~ImageViewer() {
+			qDeleteAll(m_entityToColormapMap);
+			delete m_defaultColormap;
 		}
 		void scale(float s);
 		void fitToScreen();
@@ -41,11 +52,11 @@ class ImageViewer : public QWidget {
 	signals:
 		void zoomFinished();
 		void panFinished();
-		void keypointAdded(Keypoint *keypoint);
-		void keypointRemoved(Keypoint *keypoint);
-		void keypointCorrected(Keypoint *keypoint);
+		void keypointAdded(const Keypoint& keypoint);
+		void keypointRemoved(const Keypoint& keypoint);
+		void keypointCorrected(const Keypoint& keypoint);
 		void alreadyAnnotated(bool isSuppressed);
-		void keypointChangedForReprojection(int imgSetIndex, int frameIndex);
+		void keypointChangedForReprojection(int imgSetIndex, int frameIndex, int keypointId);
 		void brightnessChanged(int brightnessFactor);
 
 	public slots:
@@ -64,6 +75,8 @@ class ImageViewer : public QWidget {
 		void labelBackgroundColorChangedSlot(QColor color);
 
 		void keypointSizeChangedSlot(int size);
+		void imageDecodedSlot(const QString& path);
+		void keypointChangedSlot(int imgSetIndex, int frameIndex, int keypointId);
 		void keypointShapeChangedSlot(const QString& entity, KeypointShape shape);
 		void colorMapChangedSlot(const QString& entity, ColorMap::ColorMapType type, QColor color);
 
@@ -72,6 +85,13 @@ class ImageViewer : public QWidget {
 		QPointF transformToImageCoordinates(QPointF rectStart);
 		void drawInfoBox(QPainter& p, QPointF point, const QString& entity, const QString& bodypart);
 		void applyImageTransformations(int hueFactor, int saturationFactor, int brightnessFactor, int contrastFactor);
+		const QImage& adjustedLevel(int level);
+		void updateCurrentKeypointId();
+		void prefetchNeighbours();
+		void showImage(const QImage& image);
+		void rebuildKeypointGrid();
+		void updateKeypointStyles();
+		void renderOverlay();
 
 		bool m_setImg = false;
 		ImgSet *m_currentImgSet;
@@ -79,9 +99,27 @@ class ImageViewer : public QWidget {
 		QList<QString> hiddenEntityList;
 		QString m_currentEntity;
 		QString m_currentBodypart;
+		int m_currentKeypointId = -1;
 		QColor m_currentColor;
-		QImage m_img;
 		QImage m_imgOriginal;
+		ImageAdjustment m_adjustment{0, 100, 100, 100};
+		QList<QImage> m_adjustedLevels;		//adjusted m_pyramid levels, null until painted
+		FrameBuffer m_adjustedBuffer;
+		QString m_currentImagePath;
+		QSize m_imageSize;
+		bool m_showingPreview = false;
+		int m_meanBrightness = -1;
+		ImagePyramid m_pyramid;
+		KeypointGrid m_keypointGrid;
+		QPointer<KeypointStore> m_connectedStore;
+		QList<QColor> m_keypointColors;					//indexed by keypointId
+		QList<KeypointShape> m_keypointShapes;
+		QList<bool> m_keypointHidden;
+		bool m_keypointStylesDirty = true;
+		QImage m_overlay;
+		QRectF m_overlayCrop;
+		float m_overlayScale = 0.0f;
+		bool m_overlayDirty = true;
 		QSize m_size;
 		QRectF m_rect;
 		QRectF m_crop;
@@ -93,7 +131,8 @@ class ImageViewer : public QWidget {
 		bool m_zoomStarted = false;
 		bool m_panActive = false;
 		bool m_panStarted = false;
-		Keypoint *m_draggedPoint = nullptr;
+		Keypoint m_draggedPoint;
+		int m_hoveredKeypointId = -1;
 		QPointF m_dragDelta;
 		QPointF m_dragReference;
 		QPointF m_previousPosition;
@@ -8,6 +8,7 @@
 	*****************************************************************/
 
 #include "keypointwidget.hpp"
+#include "profiler.hpp"
 
 #include <QErrorMessage>
 
@@ -66,6 +67,7 @@ void KeypointWidget::init() {
 																	"background-color: palette(alternate-base);}");
 	keypointlayout->addWidget(keypointTabWidget,1,0);
 	keypointListMap.clear();
+	keypointLists.clear();
 	for (const auto& entity : Dataset::dataset->entitiesList()) {
 		KeypointListWidget *bodyPartsListWidget = new KeypointListWidget();
 		bodyPartsListWidget->setAlternatingRowColors(true);
@@ -85,6 +87,7 @@ void KeypointWidget::init() {
 		bodyPartsListWidget->setCurrentItem(bodyPartsListWidget->item(0));
 		keypointTabWidget->addTab(bodyPartsListWidget, entity);
 		keypointListMap[entity] = bodyPartsListWidget;
+		keypointLists.append(bodyPartsListWidget);
 	}
 	m_currentEntity = entitiesList[0];
 	connect(keypointTabWidget, &QTabWidget::currentChanged, this, &KeypointWidget::currentTabChangedSlot);
@@ -95,8 +98,9 @@ void KeypointWidget::init() {
 }
 
 
-void KeypointWidget::keypointAddedSlot(Keypoint *keypoint) {
-	if (keypoint->state() == Suppressed) return;
+void KeypointWidget::keypointAddedSlot(const Keypoint& keypoint) {
+	PROFILE_SCOPE("Keypoint edit");
+	if (keypoint.state() == Suppressed) return;
 	//m_currentImgSet->frames[m_currentFrameIndex]->keypoints.append(keypoint);
 	//m_currentImgSet->frames[m_currentFrameIndex]->keypointMap[keypoint->ID()] = keypoint;
 	QListWidget *keypointList = keypointListMap[m_currentEntity];
@@ -122,12 +126,13 @@ void KeypointWidget::keypointAddedSlot(Keypoint *keypoint) {
 }
 
 
-void KeypointWidget::keypointRemovedSlot(Keypoint *keypoint) {
-	m_currentEntity = keypoint->entity();
-	m_currentBodypart = keypoint->bodypart();
-	keypointTabWidget->setCurrentIndex(entitiesList.indexOf(m_currentEntity));
-	QListWidget* keypointList = keypointListMap[m_currentEntity];
-	keypointList->setCurrentRow(Dataset::dataset->bodypartsList().indexOf(m_currentBodypart));
+void KeypointWidget::keypointRemovedSlot(const Keypoint& keypoint) {
+	PROFILE_SCOPE("Keypoint edit");
+	m_currentEntity = keypoint.entity();
+	m_currentBodypart = keypoint.bodypart();
+	keypointTabWidget->setCurrentIndex(keypoint.entityIndex());
+	QListWidget* keypointList = keypointLists[keypoint.entityIndex()];
+	keypointList->setCurrentRow(keypoint.bodypartIndex());
 	keypointList->item(keypointList->currentRow())->setIcon(QIcon::fromTheme("no_check"));
 	emit currentEntityChanged(m_currentEntity);
 	QColor color = colorMap->getColor(keypointList->currentRow(), keypointList->count());
@@ -135,10 +140,17 @@ void KeypointWidget::keypointRemovedSlot(Keypoint *keypoint) {
 }
 
 
-void KeypointWidget::keypointCorrectedSlot(Keypoint *keypoint) {
-	QListWidget* keypointList = keypointListMap[keypoint->entity()];
-	keypointList->item(Dataset::dataset->bodypartsList().indexOf(keypoint->bodypart()))->
-								setIcon(QIcon::fromTheme("check_blue"));
+void KeypointWidget::keypointCorrectedSlot(const Keypoint& keypoint) {
+	PROFILE_SCOPE("Keypoint edit");
+	QListWidget* keypointList = keypointLists[keypoint.entityIndex()];
+	keypointList->item(keypoint.bodypartIndex())->setIcon(QIcon::fromTheme("check_blue"));
+}
+
+
+int KeypointWidget::currentKeypointId(int row) {
+	//Tabs are created in entity order, so the tab index is the entity index
+	return Dataset::dataset->keypointStore()->keypointId(
+				keypointTabWidget->currentIndex(), row);
 }
 
 
@@ -147,9 +159,9 @@ void KeypointWidget::removeKeypointSlot(int row) {
 	keypointList->item(row)->setIcon(QIcon::fromTheme("no_check"));
 	QColor color = colorMap->getColor(row, keypointList->count());
 	m_currentBodypart = Dataset::dataset->bodypartsList()[row];
-	Keypoint *keypoint = m_currentImgSet->frames[m_currentFrameIndex]->
-											 keypointMap[m_currentEntity + "/" + m_currentBodypart];
-	keypoint->setState(NotAnnotated);
+	Keypoint keypoint = m_currentImgSet->frames[m_currentFrameIndex]->
+											 keypoint(currentKeypointId(row));
+	keypoint.setState(NotAnnotated);
 	emit currentBodypartChanged(m_currentBodypart, color);
 	emit keypointRemoved(m_currentBodypart);
 }
@@ -160,8 +172,8 @@ void KeypointWidget::suppressKeypointSlot(int row) {
 	keypointList->item(row)->setIcon(QIcon::fromTheme("discard"));
 	QColor color = colorMap->getColor(row, keypointList->count());
 	m_currentBodypart = Dataset::dataset->bodypartsList()[row];
-	m_currentImgSet->frames[m_currentFrameIndex]->keypointMap[m_currentEntity + "/" +
-													m_currentBodypart]->setState(Suppressed);
+	m_currentImgSet->frames[m_currentFrameIndex]->keypoint(currentKeypointId(row)).
+													setState(Suppressed);
 	emit currentBodypartChanged(m_currentBodypart, color);
 	emit updateViewer();
 }
@@ -172,8 +184,8 @@ void KeypointWidget::unsuppressKeypointSlot(int row) {
 	keypointList->item(row)->setIcon(QIcon::fromTheme("no_check"));
 	QColor color = colorMap->getColor(row, keypointList->count());
 	m_currentBodypart = Dataset::dataset->bodypartsList()[row];
-	m_currentImgSet->frames[m_currentFrameIndex]->keypointMap[m_currentEntity + "/" +
-													m_currentBodypart]->setState(NotAnnotated);
+	m_currentImgSet->frames[m_currentFrameIndex]->keypoint(currentKeypointId(row)).
+													setState(NotAnnotated);
 	emit currentBodypartChanged(m_currentBodypart, color);
 	emit keypointUnsuppressed(m_currentBodypart);
 }
@@ -234,26 +246,49 @@ void KeypointWidget::setKeypointsFromDatasetSlot() {
 			list->item(i)->setIcon(QIcon::fromTheme("no_check"));
 		}
 	}
-	for (const auto& keypoint : m_currentImgSet->frames[m_currentFrameIndex]->keypoints) {
-		KeypointListWidget* keypointList = keypointListMap[keypoint->entity()];
-		keypointList->setCurrentRow(Dataset::dataset->bodypartsList().indexOf(m_currentBodypart));
-		if(keypoint->state() == Reprojected) {
-			keypointList->item(Dataset::dataset->bodypartsList().indexOf(keypoint->bodypart()))->
-										setIcon(QIcon::fromTheme("check_small"));
+	Frame *frame = m_currentImgSet->frames[m_currentFrameIndex];
+	int currentRow = frame->keypointStore->bodypartIndex(m_currentBodypart);
+	for (int i = 0; i < frame->numKeypoints; i++) {
+		Keypoint keypoint = frame->keypoint(i);
+		KeypointListWidget* keypointList = keypointLists[keypoint.entityIndex()];
+		int row = keypoint.bodypartIndex();
+		keypointList->setCurrentRow(currentRow);
+		if(keypoint.state() == Reprojected) {
+			keypointList->item(row)->setIcon(QIcon::fromTheme("check_small"));
 		}
-		else if (keypoint->state() == Annotated) {
-			keypointList->item(Dataset::dataset->bodypartsList().indexOf(keypoint->bodypart()))->
-										setIcon(QIcon::fromTheme("check_blue"));
+		else if (keypoint.state() == Annotated) {
+			keypointList->item(row)->setIcon(QIcon::fromTheme("check_blue"));
 		}
-		else if (keypoint->state() == Suppressed){
-			keypointList->addSupressed(Dataset::dataset->bodypartsList().indexOf(keypoint->bodypart()));
-			keypointList->item(Dataset::dataset->bodypartsList().indexOf(keypoint->bodypart()))->
-										setIcon(QIcon::fromTheme("discard"));
+		else if (keypoint.state() == Suppressed){
+			keypointList->addSupressed(row);
+			keypointList->item(row)->setIcon(QIcon::fromTheme("discard"));
 		}
 	}
 }
 
 
+//Reprojecting a single keypoint only changes its own row
+void KeypointWidget::setKeypointFromDatasetSlot(int keypointId) {
+	Keypoint keypoint = m_currentImgSet->frames[m_currentFrameIndex]->keypoint(keypointId);
+	KeypointListWidget* keypointList = keypointLists[keypoint.entityIndex()];
+	int row = keypoint.bodypartIndex();
+	keypointList->removeSupressed(row);
+	if(keypoint.state() == Reprojected) {
+		keypointList->item(row)->setIcon(QIcon::fromTheme("check_small"));
+	}
+	else if (keypoint.state() == Annotated) {
+		keypointList->item(row)->setIcon(QIcon::fromTheme("check_blue"));
+	}
+	else if (keypoint.state() == Suppressed){
+		keypointList->addSupressed(row);
+		keypointList->item(row)->setIcon(QIcon::fromTheme("discard"));
+	}
+	else {
+		keypointList->item(row)->setIcon(QIcon::fromTheme("no_check"));
+	}
+}
+
+
 void KeypointWidget::frameChangedSlot(int currentImgSetIndex, int currentFrameIndex) {
 	Dataset::dataset->save();
 	m_currentImgSet = Dataset::dataset->imgSets()[currentImgSetIndex];
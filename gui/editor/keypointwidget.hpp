@@ -37,6 +37,9 @@ class KeypointListWidget : public QListWidget {
 		void addSupressed(int row) {
 			m_suppressedList.append(row);
 		}
+		void removeSupressed(int row) {
+			m_suppressedList.removeAll(row);
+		}
 		void clearSupressed() {
 			m_suppressedList.clear();
 		}
@@ -120,9 +123,9 @@ class KeypointWidget : public QWidget {
 		void keypointUnsuppressed(const QString& keypointName);
 
 	public slots:
-		void keypointAddedSlot(Keypoint *keypoint);
-		void keypointRemovedSlot(Keypoint *keypoint);
-		void keypointCorrectedSlot(Keypoint *keypoint);
+		void keypointAddedSlot(const Keypoint& keypoint);
+		void keypointRemovedSlot(const Keypoint& keypoint);
+		void keypointCorrectedSlot(const Keypoint& keypoint);
 		void alreadyAnnotatedSlot(bool isSuppressed);
 		void datasetLoadedSlot();
 		void removeKeypointSlot(int row);
@@ -130,6 +133,7 @@ class KeypointWidget : public QWidget {
 		void unsuppressKeypointSlot(int row);
 		void frameChangedSlot(int currentImgSetIndex, int currentFrameIndex);
 		void setKeypointsFromDatasetSlot();
+		void setKeypointFromDatasetSlot(int keypointId);
 
 	private:
 		ColorMap *colorMap;
@@ -144,6 +148,7 @@ class KeypointWidget : public QWidget {
 
 		QTabWidget *keypointTabWidget;
 		QMap<QString, KeypointListWidget*> keypointListMap;
+		QList<KeypointListWidget*> keypointLists;
 		QList<QString> bodypartsList;
 
 		QString m_currentEntity;
@@ -152,6 +157,7 @@ class KeypointWidget : public QWidget {
 		ImgSet *m_currentImgSet;
 		int m_currentFrameIndex;
 
+		int currentKeypointId(int row);
 		bool eventFilter(QObject *target, QEvent *event)
 		{
 			if (event->type() == QKeyEvent::KeyPress)
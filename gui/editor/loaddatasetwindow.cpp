@@ -180,13 +180,17 @@ void LoadDatasetWindow::loadDatasetClickedSlot() {
 	if (m_datasetFolder != "") {
 		QDir baseDir = QFileInfo(datasetFileEdit->text()).absoluteDir();
 		QString baseDirPath = baseDir.absolutePath();
-		Dataset::dataset = new Dataset(m_datasetFolder, baseDirPath,
+		//The open dataset has to be written before its files are loaded again
+		if (Dataset::dataset != nullptr) Dataset::dataset->flush();
+		Dataset *dataset = new Dataset(m_datasetFolder, baseDirPath,
 									   m_cameraNames, m_skeleton, m_segments, false);
-		if (Dataset::dataset->loadSuccessfull()) {
+		if (dataset->loadSuccessfull()) {
+			replaceDataset(dataset);
 			emit datasetLoaded(false, selectedSegmentEdit->text());
 			this->close();
 		}
 		else {
+			delete dataset;
 			QErrorMessage *msg = new QErrorMessage(this);
 			msg->showMessage("Folder is not a valid Dataset Folder.");
 		}
@@ -344,15 +348,26 @@ void LoadDatasetWindow::annotateSetupButtonClicked() {
 		}
 		QDir baseDir = QFileInfo(datasetFileEdit->text()).absoluteDir();
 		QString baseDirPath = baseDir.absolutePath();
-		Dataset::dataset = new Dataset(m_datasetFolder, baseDirPath,
+		//The open dataset has to be written before its files are loaded again
+		if (Dataset::dataset != nullptr) Dataset::dataset->flush();
+		Dataset *dataset = new Dataset(m_datasetFolder, baseDirPath,
 									   m_cameraNames, {}, m_segments, true, keypoints);
-		if (Dataset::dataset->loadSuccessfull()) {
+		if (dataset->loadSuccessfull()) {
+			replaceDataset(dataset);
 			emit datasetLoaded(true, selectedSegmentEdit->text());
 			this->close();
 		}
 		else {
+			delete dataset;
 			QErrorMessage *msg = new QErrorMessage(this);
 			msg->showMessage("Folder is not a valid Dataset Folder.");
 		}
 	}
-}
\ No newline at end of file
+}
+
+
+void LoadDatasetWindow::replaceDataset(Dataset *dataset) {
+	//Also stops the writer of the old dataset, only one may own its files
+	delete Dataset::dataset;
+	Dataset::dataset = dataset;
+}
@@ -62,6 +62,7 @@ class LoadDatasetWindow : public QDialog {
 		void addItem(const QString &text);
 		void updateCameraOrderList();
 		void updateDatasetSegmentTree();
+		void replaceDataset(Dataset *dataset);
 
 
 	private slots:
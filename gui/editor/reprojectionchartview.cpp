@@ -28,6 +28,7 @@ void ReprojectionChartView::update(std::vector<double> *reproErrors, int selecte
 	}
 	if (m_reproErrors == nullptr) return;
 	chart->removeAllSeries();
+	m_selectedIndex = selectedIndex;
 
 	if (selectedIndex != -1) {
 		chart->setTitle(Dataset::dataset->bodypartsList()[selectedIndex]);
@@ -41,22 +42,16 @@ void ReprojectionChartView::update(std::vector<double> *reproErrors, int selecte
 
     int count = 0;
     m_barSeriesList.clear();
+    m_barSetList.clear();
     for (const auto &error : *m_reproErrors) {
         QBarSeries *series = new QBarSeries();
         m_barSeriesList.append(series);
         connect(series, &QBarSeries::hovered, this,
                 &ReprojectionChartView::onHoverSlot);
         QBarSet *set = new QBarSet("Test");
-        if (error >= m_errorThreshold && count != selectedIndex) {
-            set->setColor(QColor(100, 32, 164));
-            set->setBorderColor(QColor(100, 32, 164));
-        } else if (count != selectedIndex) {
-            set->setColor(QColor(100, 164, 32));
-            set->setBorderColor(QColor(100, 164, 32));
-        } else {
-            set->setColor(QColor(32, 100, 164));
-            set->setBorderColor(QColor(32, 100, 164));
-        }
+        m_barSetList.append(set);
+        set->setColor(barColor(error, count));
+        set->setBorderColor(barColor(error, count));
         *set << error;
         series->append(set);
         chart->addSeries(series);
@@ -66,6 +61,29 @@ void ReprojectionChartView::update(std::vector<double> *reproErrors, int selecte
 }
 
 
+//Changes height and color of a single bar instead of rebuilding all series
+void ReprojectionChartView::updateBar(int index) {
+	if (m_reproErrors == nullptr || index < 0 || index >= m_barSetList.size() ||
+				m_barSetList.size() != static_cast<int>(m_reproErrors->size())) {
+		update();
+		return;
+	}
+	const double error = (*m_reproErrors)[index];
+	QBarSet *set = m_barSetList[index];
+	set->setColor(barColor(error, index));
+	set->setBorderColor(barColor(error, index));
+	set->replace(0, error);
+	axisY->setRange(0, *std::max_element(m_reproErrors->begin(), m_reproErrors->end()));
+}
+
+
+QColor ReprojectionChartView::barColor(double error, int index) const {
+	if (index == m_selectedIndex) return QColor(32, 100, 164);
+	if (error >= m_errorThreshold) return QColor(100, 32, 164);
+	return QColor(100, 164, 32);
+}
+
+
 void ReprojectionChartView::onHoverSlot() {
 	QBarSeries* series = qobject_cast<QBarSeries*>(QObject::sender());
 	int index = m_barSeriesList.indexOf(series);
@@ -27,12 +27,17 @@ class ReprojectionChartView : public QChartView {
 
 	public slots:
 		void update(std::vector<double> *reproErrors = nullptr, int selectedIndex = -1);
+		void updateBar(int index);
 		void errorThresholdChangedSlot(double value);
 
 	private:
+		QColor barColor(double error, int index) const;
+
 		double m_errorThreshold = 10.0;
-		std::vector<double> *m_reproErrors;
+		std::vector<double> *m_reproErrors = nullptr;
+		int m_selectedIndex = -1;
 		QList<QBarSeries*> m_barSeriesList;
+		QList<QBarSet*> m_barSetList;
 
 		QChart *chart;
 		QValueAxis *axisY;
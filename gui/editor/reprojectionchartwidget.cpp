@@ -8,6 +8,7 @@
 	*****************************************************************/
 
 #include "reprojectionchartwidget.hpp"
+#include "profiler.hpp"
 
 #include <random>
 
@@ -56,7 +57,16 @@ void ReprojectionChartWidget::datasetLoadedSlot() {
 
 
 void ReprojectionChartWidget::reprojectionErrorsUpdatedSlot(QMap<QString, std::vector<double> *> reprojectionErrors) {
+	PROFILE_SCOPE("Reprojection chart");
 	for (const auto& entity : reprojectionErrors.keys()) {
 		reprojectionChartViews[entity]->update(reprojectionErrors[entity]);
 	}
 }
+
+
+void ReprojectionChartWidget::reprojectionErrorChangedSlot(const QString& entity,
+			int bodypart) {
+	PROFILE_SCOPE("Reprojection chart");
+	ReprojectionChartView *chart = reprojectionChartViews.value(entity, nullptr);
+	if (chart != nullptr) chart->updateBar(bodypart);
+}
@@ -32,6 +32,7 @@ class ReprojectionChartWidget : public QWidget {
 	public slots:
 		void datasetLoadedSlot();
 		void reprojectionErrorsUpdatedSlot(QMap<QString, std::vector<double> *> reprojectionErrors);
+		void reprojectionErrorChangedSlot(const QString& entity, int bodypart);
 
 	private:
 		QTabWidget *chartsTabWidget;
@@ -8,8 +8,10 @@
 	*****************************************************************/
 
 #include "reprojectionwidget.hpp"
+#include "profiler.hpp"
 
 #include <QFileDialog>
+#include <QTimer>
 
 
 ReprojectionWidget::ReprojectionWidget(QWidget *parent) : QWidget(parent) {
@@ -35,6 +37,15 @@ ReprojectionWidget::ReprojectionWidget(QWidget *parent) : QWidget(parent) {
 
 	stackedWidget = new QStackedWidget(this);
 
+	outlierLabel = new QLabel(this);
+	outlierLabel->setWordWrap(true);
+	outlierLabel->setStyleSheet("QLabel {color: rgb(164,32,100);}");
+	outlierLabel->hide();
+
+	progressBar = new QProgressBar(this);
+	progressBar->setFormat("Reprojecting %v / %m");
+	progressBar->hide();
+
 	QLabel *loadDatasetFirstLabel = new QLabel("Load Datset First...");
 	loadDatasetFirstLabel->setFont(QFont("Sans Serif", 14, QFont::Bold));
 	loadDatasetFirstLabel->setAlignment(Qt::AlignCenter);
@@ -68,6 +79,8 @@ ReprojectionWidget::ReprojectionWidget(QWidget *parent) : QWidget(parent) {
 	reprojectionlayout->addWidget(modeLabel,1,0);
 	reprojectionlayout->addWidget(modeCombo,1,1);
 	reprojectionlayout->addWidget(stackedWidget,2,0,1,2);
+	reprojectionlayout->addWidget(outlierLabel,3,0,1,2);
+	reprojectionlayout->addWidget(progressBar,4,0,1,2);
 
 	//--- SIGNAL-SLOT Connections ---//
 	//-> Incoming Signals
@@ -82,11 +95,20 @@ ReprojectionWidget::ReprojectionWidget(QWidget *parent) : QWidget(parent) {
 
 
 void ReprojectionWidget::datasetLoadedSlot() {
+	cancelReprojectionJob();
 	m_currentImgSetIndex = 0;
 	m_currentFrameIndex = 0;
 	m_numCameras = Dataset::dataset->numCameras();
 	m_entitiesList = Dataset::dataset->entitiesList();
 	m_bodypartsList = Dataset::dataset->bodypartsList();
+	m_reconstructedImgSetIndex = -1;
+	const QList<QPair<int,int>>& bones = Dataset::dataset->skeletonBodyparts();
+	m_bonesOfBodypart.clear();
+	m_bonesOfBodypart.resize(m_bodypartsList.size());
+	for (int bone = 0; bone < bones.size(); bone++) {
+		if (bones[bone].first >= 0) m_bonesOfBodypart[bones[bone].first].append(bone);
+		if (bones[bone].second >= 0) m_bonesOfBodypart[bones[bone].second].append(bone);
+	}
 
 	stackedWidget->setCurrentWidget(calibrationSetup);
 	for (const auto& entity : Dataset::dataset->entitiesList()) {
@@ -119,7 +141,9 @@ void ReprojectionWidget::switchToggledSlot(bool toggle) {
 	}
 	else {
 		m_reprojectionActive = false;
+		cancelReprojectionJob();
 		undoReprojection();
+		outlierLabel->hide();
 	}
 	emit reprojectedPoints(Dataset::dataset->imgSets()[m_currentImgSetIndex], m_currentFrameIndex);
 	emit reprojectionToolToggled(toggle);
@@ -179,76 +203,44 @@ void ReprojectionWidget::initReprojectionClickedSlot() {
 
 
 void ReprojectionWidget::calculateReprojectionSlot(int currentImgSetIndex, int currentFrameIndex) {
+	PROFILE_SCOPE("Reprojection");
 	m_currentImgSetIndex = currentImgSetIndex;
 	m_currentFrameIndex = currentFrameIndex;
-	QMap<QString, cv::Mat> reconPointsMap;
-	QMap<QString, QVector3D> coords3D;
 	if (m_reprojectionActive) {
-		for (const auto& entity : m_entitiesList) {
-			for (const auto& bodypart : m_bodypartsList) {
-				QList<int> camsToUse;
-				QList<int> alreadyReprojected;
-				QList<QPointF> points;
-				int camCounter = 0;
-				for (const auto& frame : Dataset::dataset->imgSets()[currentImgSetIndex]->frames) {
-					if (frame->keypointMap[entity + "/" + bodypart]->state() == Annotated) {
-						camsToUse.append(camCounter);
-						points.append(frame->keypointMap[entity + "/" + bodypart]->coordinates());
-					}
-					else if (frame->keypointMap[entity + "/" + bodypart]->state() == Reprojected) {
-						alreadyReprojected.append(camCounter);
-					}
-					camCounter++;
-				}
-				if (camsToUse.size() >= m_minViews) {
-					cv::Mat X =  reprojectionTool->reconstructPoint3D(points, camsToUse);
-					coords3D[entity + "/" + bodypart] = QVector3D(X.at<double>(0), X.at<double>(1), X.at<double>(2));
-					reconPointsMap[entity + "/" + bodypart] = X;
-					QList<QPointF> reprojectedPoints = reprojectionTool->reprojectPoint(X);
-					double reprojectionError = 0;
-					for (int cam = 0; cam < reprojectedPoints.size(); cam ++) {
-						QSize imgSize = Dataset::dataset->imgSets()[currentImgSetIndex]->frames[cam]->imageDimensions;
-						QRectF imgRect(QPoint(0,0), imgSize);
-						Keypoint *keypoint = Dataset::dataset->imgSets()[currentImgSetIndex]->frames[cam]->keypointMap[entity + "/" + bodypart];
-						if (!camsToUse.contains(cam) && imgRect.contains(reprojectedPoints[cam])) {
-							if (keypoint->state() != Suppressed) {
-								keypoint->setState(Reprojected);
-								keypoint->setCoordinates(reprojectedPoints[cam]);
-							}
-						}
-						else if (keypoint->state() == Annotated) {
-							QPointF annotatedPoint = Dataset::dataset->imgSets()[currentImgSetIndex]->frames[cam]->keypointMap[entity + "/" + bodypart]->coordinates();
-							QPointF dist = annotatedPoint-reprojectedPoints[cam];
-							reprojectionError += sqrt(dist.x()*dist.x()+dist.y()*dist.y())/reprojectedPoints.size();
-						}
-					}
-						(*m_reprojectionErrors[entity])[Dataset::dataset->bodypartsList().indexOf(bodypart)] = reprojectionError;
-				}
-				else {
-					(*m_reprojectionErrors[entity])[Dataset::dataset->bodypartsList().indexOf(bodypart)] = 0;
-					for (int cam = 0; cam < Dataset::dataset->numCameras(); cam ++) {
-						Keypoint *keypoint = Dataset::dataset->imgSets()[currentImgSetIndex]->frames[cam]->keypointMap[entity + "/" + bodypart];
-						if (keypoint->state() == Reprojected) {
-							keypoint->setState(NotAnnotated);
-						}
-					}
+		KeypointStore *store = Dataset::dataset->keypointStore();
+		ImgSet *imgSet = Dataset::dataset->imgSets()[currentImgSetIndex];
+		const int numKeypoints = store->numKeypoints();
+		const int numBodyparts = m_bodypartsList.size();
+		const std::vector<int> keypointIds = allKeypointIds();
+		std::vector<double> reprojectionErrors;
+		reprojectKeypoints(imgSet, keypointIds, &m_points3D, &m_reconstructed,
+					&m_outliers, &reprojectionErrors);
+		m_reconstructedImgSetIndex = currentImgSetIndex;
+		m_setsReprojected.insert(currentImgSetIndex);
+
+		m_coords3D.coords.fill(QVector3D(), numKeypoints);
+		m_coords3D.valid.fill(false, numKeypoints);
+		for (int entity = 0; entity < m_entitiesList.size(); entity++) {
+			std::vector<double> *errors = m_reprojectionErrors[m_entitiesList[entity]];
+			for (int bodypart = 0; bodypart < numBodyparts; bodypart++) {
+				int index = entity*numBodyparts + bodypart;
+				if (m_reconstructed.at<uchar>(index)) {
+					const double *X = m_points3D.ptr<double>(index);
+					m_coords3D.coords[keypointIds[index]] = QVector3D(X[0], X[1], X[2]);
+					m_coords3D.valid[keypointIds[index]] = true;
 				}
+				(*errors)[bodypart] = reprojectionErrors[index];
 			}
 		}
-		for (const auto& entity : m_entitiesList) {
-			int idx = 0;
-			for (const auto& comp : Dataset::dataset->skeleton()) {
-				if (reconPointsMap.contains(entity + "/" + comp.keypointA) && reconPointsMap.contains(entity + "/" + comp.keypointB)) {
-					double dist = cv::norm(reconPointsMap[entity + "/" + comp.keypointA], reconPointsMap[entity + "/" +  comp.keypointB]);
-					(*m_boneLengthErrors[entity])[idx++] = dist - comp.length;
-				}
-				else {
-					(*m_boneLengthErrors[entity])[idx++] = 0.0;
-				}
+		const int numBones = Dataset::dataset->skeletonBodyparts().size();
+		for (int entity = 0; entity < m_entitiesList.size(); entity++) {
+			for (int bone = 0; bone < numBones; bone++) {
+				updateBoneLengthError(entity, bone);
 			}
 		}
-		emit reprojectedPoints(Dataset::dataset->imgSets()[currentImgSetIndex], currentFrameIndex);
-		emit update3DCoords(coords3D);
+		updateOutlierLabel();
+		emit reprojectedPoints(imgSet, currentFrameIndex);
+		emit update3DCoords(m_coords3D);
 
 		emit reprojectionToolToggled(true);
 		reprojectionChartWidget->reprojectionErrorsUpdatedSlot(m_reprojectionErrors);
@@ -257,68 +249,258 @@ void ReprojectionWidget::calculateReprojectionSlot(int currentImgSetIndex, int c
 }
 
 
+//Only the edited (entity, bodypart) depends on the keypoint, so only it is
+//triangulated again and only its error and the bones attached to it change.
+//The keypoint list and the 3D view are handed just that keypoint as well.
+void ReprojectionWidget::keypointChangedSlot(int imgSetIndex, int frameIndex,
+			int keypointId) {
+	if (!m_reprojectionActive) return;
+	if (imgSetIndex != m_reconstructedImgSetIndex || keypointId < 0) {
+		calculateReprojectionSlot(imgSetIndex, frameIndex);
+		return;
+	}
+	PROFILE_SCOPE("Reprojection (keypoint)");
+	m_currentFrameIndex = frameIndex;
+	KeypointStore *store = Dataset::dataset->keypointStore();
+	ImgSet *imgSet = Dataset::dataset->imgSets()[imgSetIndex];
+	const int entity = store->entityIndex(keypointId);
+	const int bodypart = store->bodypartIndex(keypointId);
+	const int index = entity*m_bodypartsList.size() + bodypart;
+
+	cv::Mat points3D, reconstructed, outliers;
+	std::vector<double> reprojectionErrors;
+	reprojectKeypoints(imgSet, {keypointId}, &points3D, &reconstructed, &outliers,
+				&reprojectionErrors);
+	points3D.copyTo(m_points3D.row(index));
+	outliers.copyTo(m_outliers.row(index));
+	m_reconstructed.at<uchar>(index) = reconstructed.at<uchar>(0);
+	if (reconstructed.at<uchar>(0)) {
+		const double *X = points3D.ptr<double>(0);
+		m_coords3D.coords[keypointId] = QVector3D(X[0], X[1], X[2]);
+	}
+	m_coords3D.valid[keypointId] = reconstructed.at<uchar>(0);
+	const QString& entityName = m_entitiesList[entity];
+	(*m_reprojectionErrors[entityName])[bodypart] = reprojectionErrors[0];
+	for (const auto& bone : m_bonesOfBodypart[bodypart]) {
+		updateBoneLengthError(entity, bone);
+	}
+
+	updateOutlierLabel();
+	emit reprojectedKeypoint(keypointId);
+	emit update3DCoord(keypointId, m_coords3D.coords[keypointId],
+				m_coords3D.valid[keypointId]);
+	emit reprojectionToolToggled(true);
+	reprojectionChartWidget->reprojectionErrorChangedSlot(entityName, bodypart);
+	for (const auto& bone : m_bonesOfBodypart[bodypart]) {
+		boneLengthChartWidget->boneLengthErrorChangedSlot(entityName, bone);
+	}
+}
+
+
+void ReprojectionWidget::updateBoneLengthError(int entity, int bone) {
+	const QPair<int,int>& bodyparts = Dataset::dataset->skeletonBodyparts()[bone];
+	const int numBodyparts = m_bodypartsList.size();
+	std::vector<double> *errors = m_boneLengthErrors[m_entitiesList[entity]];
+	if (bodyparts.first < 0 || bodyparts.second < 0) {
+		(*errors)[bone] = 0.0;
+		return;
+	}
+	int indexA = entity*numBodyparts + bodyparts.first;
+	int indexB = entity*numBodyparts + bodyparts.second;
+	if (m_reconstructed.at<uchar>(indexA) && m_reconstructed.at<uchar>(indexB)) {
+		double dist = cv::norm(m_points3D.row(indexA), m_points3D.row(indexB));
+		(*errors)[bone] = dist - Dataset::dataset->skeleton().at(bone).length;
+	}
+	else {
+		(*errors)[bone] = 0.0;
+	}
+}
+
+
+//Sets are handed to a ReprojectionJob in order of their distance to the
+//current set, the current one itself is reprojected synchronously by
+//calculateReprojectionSlot anyway. Results are committed in batches.
 void ReprojectionWidget::calculateAllReprojections() {
-	if (m_reprojectionActive) {
-		for (const auto& imgSet : Dataset::dataset->imgSets()) {
-			for (const auto& entity : m_entitiesList) {
-				for (const auto& bodypart : m_bodypartsList) {
-					QList<int> camsToUse;
-					QList<int> alreadyReprojected;
-					QList<QPointF> points;
-					int camCounter = 0;
-					for (const auto& frame : imgSet->frames) {
-						if (frame->keypointMap[entity + "/" + bodypart]->state() == Annotated) {
-							camsToUse.append(camCounter);
-							points.append(frame->keypointMap[entity + "/" + bodypart]->coordinates());
-						}
-						else if (frame->keypointMap[entity + "/" + bodypart]->state() == Reprojected) {
-							alreadyReprojected.append(camCounter);
-						}
-						camCounter++;
-					}
-					if (camsToUse.size() >= m_minViews) {
-						cv::Mat X =  reprojectionTool->reconstructPoint3D(points, camsToUse);
-						QList<QPointF> reprojectedPoints = reprojectionTool->reprojectPoint(X);
-						double reprojectionError = 0;
-						for (int cam = 0; cam < reprojectedPoints.size(); cam ++) {
-							QSize imgSize =imgSet->frames[cam]->imageDimensions;
-							QRectF imgRect(QPoint(0,0), imgSize);
-							Keypoint *keypoint = imgSet->frames[cam]->keypointMap[entity + "/" + bodypart];
-							if (!camsToUse.contains(cam) && imgRect.contains(reprojectedPoints[cam])) {
-								if (keypoint->state() != Suppressed) {
-									keypoint->setState(Reprojected);
-									keypoint->setCoordinates(reprojectedPoints[cam]);
-								}
-							}
-							else if (keypoint->state() == Annotated) {
-								QPointF annotatedPoint = imgSet->frames[cam]->keypointMap[entity + "/" + bodypart]->coordinates();
-								QPointF dist = annotatedPoint-reprojectedPoints[cam];
-								reprojectionError += sqrt(dist.x()*dist.x()+dist.y()*dist.y())/reprojectedPoints.size();
-							}
-						}
-							(*m_reprojectionErrors[entity])[Dataset::dataset->bodypartsList().indexOf(bodypart)] = reprojectionError;
-					}
-					else {
-						(*m_reprojectionErrors[entity])[Dataset::dataset->bodypartsList().indexOf(bodypart)] = 0;
-						for (int cam = 0; cam < Dataset::dataset->numCameras(); cam ++) {
-							Keypoint *keypoint = imgSet->frames[cam]->keypointMap[entity + "/" + bodypart];
-							if (keypoint->state() == Reprojected) {
-								keypoint->setState(NotAnnotated);
-							}
-						}
-					}
+	PROFILE_SCOPE("Reprojection (all)");
+	cancelReprojectionJob();
+	if (!m_reprojectionActive) return;
+	const QList<ImgSet*>& imgSets = Dataset::dataset->imgSets();
+	if (imgSets.isEmpty()) return;
+	const std::vector<int> keypointIds = allKeypointIds();
+	std::vector<ReprojectionJob::SetBuffer> sets;
+	sets.reserve(imgSets.size());
+	QList<int> order = {m_currentImgSetIndex};
+	for (int distance = 1; order.size() < imgSets.size(); distance++) {
+		if (m_currentImgSetIndex + distance < imgSets.size()) {
+			order.append(m_currentImgSetIndex + distance);
+		}
+		if (m_currentImgSetIndex - distance >= 0) {
+			order.append(m_currentImgSetIndex - distance);
+		}
+	}
+	for (const auto& index : order) {
+		ReprojectionJob::SetBuffer set;
+		set.imgSetIndex = index;
+		gatherKeypoints(imgSets[index], keypointIds, &set.points, &set.valid);
+		sets.push_back(std::move(set));
+	}
+	m_keypointIdsOfJob = keypointIds;
+	m_setsReprojected.clear();
+	m_reprojectionJob = new ReprojectionJob(reprojectionTool, std::move(sets),
+				m_outlierThreshold, this);
+	connect(m_reprojectionJob, &ReprojectionJob::setsFinished, this,
+				&ReprojectionWidget::reprojectionSetsFinishedSlot, Qt::QueuedConnection);
+	progressBar->setRange(0, m_reprojectionJob->numSets());
+	progressBar->setValue(0);
+	progressBar->show();
+	m_reprojectionJob->start();
+}
+
+
+void ReprojectionWidget::cancelReprojectionJob() {
+	if (m_reprojectionJob == nullptr) return;
+	m_reprojectionJob->cancel();
+	delete m_reprojectionJob;
+	m_reprojectionJob = nullptr;
+	progressBar->hide();
+}
+
+
+//Commits a limited number of sets per event loop iteration so the GUI stays
+//responsive, sets that were reprojected synchronously in the meantime are
+//newer than the job's result and are skipped
+void ReprojectionWidget::reprojectionSetsFinishedSlot() {
+	if (m_reprojectionJob == nullptr) return;
+	PROFILE_SCOPE("Reprojection commit");
+	const int batchSize = 32;
+	const QList<ImgSet*>& imgSets = Dataset::dataset->imgSets();
+	QList<const ReprojectionJob::SetBuffer*> sets = m_reprojectionJob->takeFinished(batchSize);
+	for (const auto& set : sets) {
+		if (m_setsReprojected.contains(set->imgSetIndex)) continue;
+		applyReprojection(imgSets[set->imgSetIndex], m_keypointIdsOfJob, set->valid,
+					set->reconstructed, set->projected, nullptr);
+	}
+	progressBar->setValue(m_reprojectionJob->numTaken());
+	if (m_reprojectionJob->isDone()) {
+		cancelReprojectionJob();
+	}
+	else if (sets.size() == batchSize) {
+		//More might be waiting, the job only signals when its queue was empty
+		QTimer::singleShot(0, this, &ReprojectionWidget::reprojectionSetsFinishedSlot);
+	}
+}
+
+
+//Triangulates all given keypoints of the set in one batch and writes the
+//reprojections into the views they are not annotated in. Ids < 0 are skipped.
+//outliers flags the annotated views the robust triangulation rejected.
+void ReprojectionWidget::reprojectKeypoints(ImgSet *imgSet,
+			const std::vector<int>& keypointIds, cv::Mat *points3D,
+			cv::Mat *reconstructed, cv::Mat *outliers,
+			std::vector<double> *reprojectionErrors) {
+	cv::Mat points, valid, projected;
+	gatherKeypoints(imgSet, keypointIds, &points, &valid);
+	if (m_outlierThreshold > 0.0) {
+		cv::Mat inliers;
+		reprojectionTool->reconstructPoints3DRobust(points, valid, m_outlierThreshold,
+					*points3D, *reconstructed, inliers);
+		*outliers = valid & ~inliers;
+	}
+	else {
+		reprojectionTool->reconstructPoints3D(points, valid, *points3D, *reconstructed);
+		*outliers = cv::Mat::zeros(valid.size(), CV_8U);
+	}
+	reprojectionTool->projectPoints(*points3D, projected);
+	applyReprojection(imgSet, keypointIds, valid, *reconstructed, projected,
+				reprojectionErrors);
+}
+
+
+//Collects the annotated views of every keypoint, keypoints with less than
+//m_minViews annotations get no valid view at all
+void ReprojectionWidget::gatherKeypoints(ImgSet *imgSet,
+			const std::vector<int>& keypointIds, cv::Mat *points, cv::Mat *valid) {
+	const int numPoints = keypointIds.size();
+	const int numCameras = imgSet->frames.size();
+	points->create(numPoints, numCameras, CV_64FC2);
+	points->setTo(cv::Scalar(0.0, 0.0));
+	*valid = cv::Mat::zeros(numPoints, numCameras, CV_8U);
+	std::vector<int> numViews(numPoints, 0);
+	for (int cam = 0; cam < numCameras; cam++) {
+		for (int i = 0; i < numPoints; i++) {
+			if (keypointIds[i] < 0) continue;
+			Keypoint keypoint = imgSet->frames[cam]->keypoint(keypointIds[i]);
+			if (keypoint.state() == Annotated) {
+				QPointF coordinates = keypoint.coordinates();
+				points->at<cv::Vec2d>(i, cam) = cv::Vec2d(coordinates.x(), coordinates.y());
+				valid->at<uchar>(i, cam) = 1;
+				numViews[i]++;
+			}
+		}
+	}
+	for (int i = 0; i < numPoints; i++) {
+		if (numViews[i] < m_minViews) valid->row(i).setTo(0);
+	}
+}
+
+
+void ReprojectionWidget::applyReprojection(ImgSet *imgSet,
+			const std::vector<int>& keypointIds, const cv::Mat& valid,
+			const cv::Mat& reconstructed, const cv::Mat& projected,
+			std::vector<double> *reprojectionErrors) {
+	const int numPoints = keypointIds.size();
+	const int numCameras = imgSet->frames.size();
+	if (reprojectionErrors != nullptr) reprojectionErrors->assign(numPoints, 0.0);
+	for (int i = 0; i < numPoints; i++) {
+		if (keypointIds[i] < 0) continue;
+		if (!reconstructed.at<uchar>(i)) {
+			for (int cam = 0; cam < numCameras; cam ++) {
+				Keypoint keypoint = imgSet->frames[cam]->keypoint(keypointIds[i]);
+				if (keypoint.state() == Reprojected) {
+					keypoint.setState(NotAnnotated);
+				}
+			}
+			continue;
+		}
+		for (int cam = 0; cam < numCameras; cam ++) {
+			const cv::Vec2d& p = projected.at<cv::Vec2d>(i, cam);
+			QPointF reprojectedPoint(p[0], p[1]);
+			QRectF imgRect(QPoint(0,0), imgSet->frames[cam]->imageDimensions);
+			Keypoint keypoint = imgSet->frames[cam]->keypoint(keypointIds[i]);
+			if (!valid.at<uchar>(i, cam) && imgRect.contains(reprojectedPoint)) {
+				if (keypoint.state() != Suppressed) {
+					keypoint.setState(Reprojected);
+					keypoint.setCoordinates(reprojectedPoint);
 				}
 			}
+			else if (keypoint.state() == Annotated && reprojectionErrors != nullptr) {
+				QPointF dist = keypoint.coordinates()-reprojectedPoint;
+				(*reprojectionErrors)[i] += sqrt(dist.x()*dist.x()+dist.y()*dist.y())/
+							numCameras;
+			}
 		}
 	}
 }
 
 
+std::vector<int> ReprojectionWidget::allKeypointIds() const {
+	KeypointStore *store = Dataset::dataset->keypointStore();
+	std::vector<int> keypointIds;
+	for (int entity = 0; entity < m_entitiesList.size(); entity++) {
+		for (int bodypart = 0; bodypart < m_bodypartsList.size(); bodypart++) {
+			keypointIds.push_back(store->keypointId(entity, bodypart));
+		}
+	}
+	return keypointIds;
+}
+
+
 void ReprojectionWidget::undoReprojection() {
 	for (auto& imgSet : Dataset::dataset->imgSets()) {
 		for (auto& frame : imgSet->frames) {
-			for (auto& keypoint : frame->keypoints) {
-				if (keypoint->state() == Reprojected) keypoint->setState(NotAnnotated);
+			for (int i = 0; i < frame->numKeypoints; i++) {
+				Keypoint keypoint = frame->keypoint(i);
+				if (keypoint.state() == Reprojected) keypoint.setState(NotAnnotated);
 			}
 		}
 	}
@@ -331,6 +513,9 @@ void ReprojectionWidget::getSettings() {
 	if (settings->contains("MinViews")) {
 		m_minViews = settings->value("MinViews").toInt();
 	}
+	if (settings->contains("outlierThreshold")) {
+		m_outlierThreshold = settings->value("outlierThreshold").toDouble();
+	}
 	minViewsChangedSlot(m_minViews);
 	// if (settings->contains("errorThreshold")) {
 	// 	m_errorThreshold = settings->value("errorThreshold").toDouble();
@@ -348,6 +533,30 @@ void ReprojectionWidget::minViewsChangedSlot(int value) {
 }
 
 
+void ReprojectionWidget::outlierThresholdChangedSlot(double value) {
+	m_outlierThreshold = value;
+	calculateAllReprojections();
+	calculateReprojectionSlot(m_currentImgSetIndex, m_currentFrameIndex);
+}
+
+
+void ReprojectionWidget::updateOutlierLabel() {
+	QList<QString> outlierViews;
+	for (int row = 0; row < m_outliers.rows; row++) {
+		const uchar *outliers = m_outliers.ptr<uchar>(row);
+		for (int cam = 0; cam < m_outliers.cols; cam++) {
+			if (!outliers[cam]) continue;
+			const QString& entity = m_entitiesList[row/m_bodypartsList.size()];
+			const QString& bodypart = m_bodypartsList[row%m_bodypartsList.size()];
+			outlierViews.append(entity + " " + bodypart + " (" +
+						Dataset::dataset->cameraName(cam) + ")");
+		}
+	}
+	outlierLabel->setText("Outlier views: " + outlierViews.join(", "));
+	outlierLabel->setVisible(!outlierViews.isEmpty());
+}
+
+
 // void ReprojectionWidget::errorThresholdChangedSlot(double value) {
 // 	m_errorThreshold = value;
 // 	emit errorThresholdChanged(value);
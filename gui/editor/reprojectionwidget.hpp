@@ -13,6 +13,7 @@
 #include "globals.hpp"
 #include "dataset.hpp"
 #include "reprojectiontool.hpp"
+#include "reprojectionjob.hpp"
 #include "switch.hpp"
 #include "colormap.hpp"
 #include "reprojectionchartwidget.hpp"
@@ -29,6 +30,7 @@
 #include <QSettings>
 #include <QSpinBox>
 #include <QDoubleSpinBox>
+#include <QProgressBar>
 
 
 class ReprojectionWidget : public QWidget {
@@ -39,7 +41,9 @@ class ReprojectionWidget : public QWidget {
 
 	signals:
 		void reprojectedPoints(ImgSet *imgSet, int frameIndex);
-		void update3DCoords(QMap<QString, QVector3D> coords3D);
+		void update3DCoords(const KeypointCoords3D& coords3D);
+		void reprojectedKeypoint(int keypointId);
+		void update3DCoord(int keypointId, const QVector3D& coord3D, bool valid);
 		void reprojectionToolToggled(bool toggle);
 		void datasetLoaded();
 		void errorThresholdChanged(double value);
@@ -50,7 +54,9 @@ class ReprojectionWidget : public QWidget {
 	public slots:
 		void datasetLoadedSlot();
 		void calculateReprojectionSlot(int currentImgSetIndex, int currentFrameIndex);
+		void keypointChangedSlot(int imgSetIndex, int frameIndex, int keypointId);
 		void minViewsChangedSlot(int value);
+		void outlierThresholdChangedSlot(double value);
 		// void errorThresholdChangedSlot(double value);
 		// void boneLengthErrorThresholdChangedSlot(double value);
 
@@ -58,7 +64,19 @@ class ReprojectionWidget : public QWidget {
 		bool checkCalibParams(const QString &path);
 		void undoReprojection();
 		void calculateAllReprojections();
+		void cancelReprojectionJob();
+		void reprojectKeypoints(ImgSet *imgSet, const std::vector<int>& keypointIds,
+					cv::Mat *points3D, cv::Mat *reconstructed, cv::Mat *outliers,
+					std::vector<double> *reprojectionErrors);
+		void gatherKeypoints(ImgSet *imgSet, const std::vector<int>& keypointIds,
+					cv::Mat *points, cv::Mat *valid);
+		void applyReprojection(ImgSet *imgSet, const std::vector<int>& keypointIds,
+					const cv::Mat& valid, const cv::Mat& reconstructed,
+					const cv::Mat& projected, std::vector<double> *reprojectionErrors);
+		std::vector<int> allKeypointIds() const;
 		void getSettings();
+		void updateBoneLengthError(int entity, int bone);
+		void updateOutlierLabel();
 
 		ReprojectionChartWidget *reprojectionChartWidget;
 		BoneLengthChartWidget *boneLengthChartWidget;
@@ -71,6 +89,8 @@ class ReprojectionWidget : public QWidget {
 		QLabel *modeLabel;
 		QComboBox *modeCombo;
 		QStackedWidget *stackedWidget;
+		QLabel *outlierLabel;
+		QProgressBar *progressBar;
 
 		QWidget *calibrationSetup;
 		QPushButton *initReprojectionButton;
@@ -82,6 +102,7 @@ class ReprojectionWidget : public QWidget {
 		bool m_calibExists = false;
 		int m_numCameras = 0;
 		int m_minViews = 2;
+		double m_outlierThreshold = 0.0;				//0 disables the robust triangulation
 		double m_errorThreshold = 10.0;
 		QList<QString> m_entitiesList;
 		QList<QString> m_bodypartsList;
@@ -89,6 +110,16 @@ class ReprojectionWidget : public QWidget {
 		int m_currentFrameIndex = 0;
 		QMap<QString, std::vector<double> *> m_reprojectionErrors;
 		QMap<QString, std::vector<double> *> m_boneLengthErrors;
+		//Triangulation of the current set, rows are entity*numBodyparts + bodypart
+		int m_reconstructedImgSetIndex = -1;
+		cv::Mat m_points3D;
+		cv::Mat m_reconstructed;
+		cv::Mat m_outliers;
+		KeypointCoords3D m_coords3D;
+		QList<QList<int>> m_bonesOfBodypart;
+		ReprojectionJob *m_reprojectionJob = nullptr;
+		std::vector<int> m_keypointIdsOfJob;
+		QSet<int> m_setsReprojected;
 
 
 		QDir m_parameterDir;
@@ -97,6 +128,7 @@ class ReprojectionWidget : public QWidget {
 		void switchToggledSlot(bool toggle);
 		void initReprojectionClickedSlot();
 		void modeComboChangedSlot(const QString& mode);
+		void reprojectionSetsFinishedSlot();
 };
 
 #endif
@@ -77,12 +77,12 @@ void ViewPort::setCameraLense(float focalLength, QSize imgSize) {
 }
 
 void ViewPort::reset() {
-    for (auto & entity : m_keypointEntities.values()) {
-        entity->deleteLater();
+    for (auto & entity : m_keypointEntities) {
+        if (entity != nullptr) entity->deleteLater();
 	}
 	m_keypointEntities.clear();
-	for (auto & entity : m_skeletonEntities.values()) {
-		entity->deleteLater();
+	for (auto & entity : m_skeletonEntities) {
+		if (entity != nullptr) entity->deleteLater();
 	}
 	m_skeletonEntities.clear();
 	m_skeletonEndPoints.clear();
@@ -227,94 +227,163 @@ void ViewPort::addSetup(QList<QVector3D> coords, float cornerRadius, QColor corn
 void ViewPort::update() {
 	int count = 0;
 	m_center = QVector3D(0,0,0);
-	for (const auto &entity : Dataset::dataset->entitiesList())
+	KeypointStore *store = Dataset::dataset->keypointStore();
+	const QList<QPair<int,int>>& bones = Dataset::dataset->skeletonBodyparts();
+	const int numEntities = store->numEntities();
+	const int numBodyparts = store->numBodyparts();
+	if (m_keypointEntities.size() != store->numKeypoints()) {
+		m_keypointEntities.resize(store->numKeypoints(), nullptr);
+	}
+	if (m_skeletonEntities.size() != numEntities*bones.size()) {
+		m_skeletonEntities.resize(numEntities*bones.size(), nullptr);
+		m_skeletonEndPoints.resize(numEntities*bones.size());
+	}
+	for (int entity = 0; entity < numEntities; entity++)
 	{
-		for (const auto &bodypart : Dataset::dataset->bodypartsList())
+		for (int bodypart = 0; bodypart < numBodyparts; bodypart++)
 		{
-			QString id = entity + "/" + bodypart;
-			if (m_coords3D.contains(id)) {
-				QVector3D coord3D = m_coords3D[id];
-				m_center += coord3D;
+			int id = store->keypointId(entity, bodypart);
+			if (id < 0) continue;
+			if (hasCoords(id)) {
+				m_center += m_coords3D.coords[id];
 				count++;
-				if (m_keypointEntities.contains(id)) {
-					Qt3DCore::QEntity *keypoint = m_keypointEntities[id];
-					Qt3DCore::QTransform *transform = keypoint->componentsOfType<Qt3DCore::QTransform>()[0];
-					QVector3D old_translation = transform->translation();
-					if (old_translation != coord3D) {
-						transform->setTranslation(coord3D);
-						adjustView();
-						m_camMoveCounter -= 3;
-					}
-				}
-				else {
-					QColor color = Dataset::dataset->imgSets()[0]->frames[0]->keypointMap[id]->color();
-					m_keypointEntities[id] = addSphere(coord3D, m_keypointRadius,color, animalEntity);
-					adjustView();
-					m_camMoveCounter -= 3;
-				}
-			}
-			else {
-				if (m_keypointEntities.contains(id)) {
-					m_keypointEntities[id]->deleteLater();
-					m_keypointEntities.remove(id);
-					adjustView();
-					m_camMoveCounter -= 3;
-				}
-			}
-		for (const auto &bone : Dataset::dataset->skeleton()) {
-			QString idA = entity + "/" + bone.keypointA;
-			QString idB = entity + "/" + bone.keypointB;
-			QString id = idA + "-" + idB;
-			if (m_coords3D.contains(idA) && m_coords3D.contains(idB)) {
-				QVector3D coordsA = m_coords3D[idA];
-				QVector3D coordsB = m_coords3D[idB];
-				if (m_skeletonEntities.contains(id)) {
-					QVector3D old_start = m_skeletonEndPoints[id].first;
-					QVector3D old_end = m_skeletonEndPoints[id].second;
-					if (old_start != coordsA || old_end != coordsB) {
-						Qt3DCore::QEntity *bone = m_skeletonEntities[id];
-						Qt3DCore::QTransform *transform = bone->componentsOfType<Qt3DCore::QTransform>()[0];
-						Qt3DExtras::QCylinderMesh *cylinderMesh = bone->componentsOfType<Qt3DExtras::QCylinderMesh>()[0];
-						QVector3D vecAB = coordsB - coordsA;
-						float vecABLength = vecAB.length();
-						cylinderMesh->setLength(vecABLength);
-						QVector3D cylinderVect(0, 1, 0);
-						QVector3D a = QVector3D::crossProduct(cylinderVect, vecAB);
-						float w = vecABLength + QVector3D::dotProduct(cylinderVect, vecAB);
-						QQuaternion q(w,a);
-						q.normalize();
-						transform->setTranslation(coordsA + q*QVector3D(0, vecABLength / 2, 0));
-						transform->setRotation(q);
-						adjustView();
-						m_camMoveCounter -= 3;
-						m_skeletonEndPoints[id] = QPair<QVector3D,QVector3D>(coordsA, coordsB);
-
-					}
-				}
-				else {
-					m_skeletonEntities[id] = addJoint(coordsA, coordsB, m_skeletonThickness, QColor(150, 150, 150));
-					m_skeletonEndPoints[id] = QPair<QVector3D,QVector3D>(coordsA, coordsB);
-					adjustView();
-					m_camMoveCounter -= 3;
-				}
-			}
-			else {
-				if (m_skeletonEntities.contains(id)) {
-					m_skeletonEntities[id]->deleteLater();
-					m_skeletonEntities.remove(id);
-					m_skeletonEndPoints.remove(id);
-					adjustView();
-					m_camMoveCounter -= 3;
-				}
 			}
+			updateKeypointEntity(id);
 		}
+		for (int boneIndex = 0; boneIndex < bones.size(); boneIndex++) {
+			updateBoneEntity(entity, boneIndex);
 		}
 	}
+	m_centerCount = count;
 	if (count != 0) {
 		m_center = m_center / count;
 	}
 }
 
+
+//Only the sphere of the keypoint and the bones attached to it depend on its
+//coordinates, the center is moved by the difference to the old ones
+void ViewPort::setCoord3D(int keypointId, const QVector3D& coord3D,
+			bool valid) {
+	if (keypointId < 0 || keypointId >= m_coords3D.valid.size()) return;
+	QVector3D sum = m_center*m_centerCount;
+	if (m_coords3D.valid[keypointId]) {
+		sum -= m_coords3D.coords[keypointId];
+		m_centerCount--;
+	}
+	if (valid) {
+		m_coords3D.coords[keypointId] = coord3D;
+		sum += coord3D;
+		m_centerCount++;
+	}
+	m_coords3D.valid[keypointId] = valid;
+	m_center = (m_centerCount != 0) ? sum / m_centerCount : QVector3D(0,0,0);
+
+	KeypointStore *store = Dataset::dataset->keypointStore();
+	const QList<QPair<int,int>>& bones = Dataset::dataset->skeletonBodyparts();
+	//Entities were reset since the last full update
+	if (m_keypointEntities.size() != store->numKeypoints() ||
+				m_skeletonEntities.size() != store->numEntities()*bones.size()) {
+		update();
+		return;
+	}
+	const int entity = store->entityIndex(keypointId);
+	const int bodypart = store->bodypartIndex(keypointId);
+	updateKeypointEntity(keypointId);
+	for (int boneIndex = 0; boneIndex < bones.size(); boneIndex++) {
+		if (bones[boneIndex].first == bodypart ||
+					bones[boneIndex].second == bodypart) {
+			updateBoneEntity(entity, boneIndex);
+		}
+	}
+}
+
+
+bool ViewPort::hasCoords(int id) const {
+	return id >= 0 && id < m_coords3D.valid.size() && m_coords3D.valid[id];
+}
+
+
+void ViewPort::updateKeypointEntity(int id) {
+	if (hasCoords(id)) {
+		QVector3D coord3D = m_coords3D.coords[id];
+		if (m_keypointEntities[id] != nullptr) {
+			Qt3DCore::QEntity *keypoint = m_keypointEntities[id];
+			Qt3DCore::QTransform *transform = keypoint->componentsOfType<Qt3DCore::QTransform>()[0];
+			QVector3D old_translation = transform->translation();
+			if (old_translation != coord3D) {
+				transform->setTranslation(coord3D);
+				adjustView();
+				m_camMoveCounter -= 3;
+			}
+		}
+		else {
+			QColor color = Dataset::dataset->keypointStore()->color(id);
+			m_keypointEntities[id] = addSphere(coord3D, m_keypointRadius,color, animalEntity);
+			adjustView();
+			m_camMoveCounter -= 3;
+		}
+	}
+	else {
+		if (m_keypointEntities[id] != nullptr) {
+			m_keypointEntities[id]->deleteLater();
+			m_keypointEntities[id] = nullptr;
+			adjustView();
+			m_camMoveCounter -= 3;
+		}
+	}
+}
+
+
+void ViewPort::updateBoneEntity(int entity, int boneIndex) {
+	KeypointStore *store = Dataset::dataset->keypointStore();
+	const QList<QPair<int,int>>& bones = Dataset::dataset->skeletonBodyparts();
+	int idA = store->keypointId(entity, bones[boneIndex].first);
+	int idB = store->keypointId(entity, bones[boneIndex].second);
+	int id = entity*bones.size() + boneIndex;
+	if (hasCoords(idA) && hasCoords(idB)) {
+		QVector3D coordsA = m_coords3D.coords[idA];
+		QVector3D coordsB = m_coords3D.coords[idB];
+		if (m_skeletonEntities[id] != nullptr) {
+			QVector3D old_start = m_skeletonEndPoints[id].first;
+			QVector3D old_end = m_skeletonEndPoints[id].second;
+			if (old_start != coordsA || old_end != coordsB) {
+				Qt3DCore::QEntity *bone = m_skeletonEntities[id];
+				Qt3DCore::QTransform *transform = bone->componentsOfType<Qt3DCore::QTransform>()[0];
+				Qt3DExtras::QCylinderMesh *cylinderMesh = bone->componentsOfType<Qt3DExtras::QCylinderMesh>()[0];
+				QVector3D vecAB = coordsB - coordsA;
+				float vecABLength = vecAB.length();
+				cylinderMesh->setLength(vecABLength);
+				QVector3D cylinderVect(0, 1, 0);
+				QVector3D a = QVector3D::crossProduct(cylinderVect, vecAB);
+				float w = vecABLength + QVector3D::dotProduct(cylinderVect, vecAB);
+				QQuaternion q(w,a);
+				q.normalize();
+				transform->setTranslation(coordsA + q*QVector3D(0, vecABLength / 2, 0));
+				transform->setRotation(q);
+				adjustView();
+				m_camMoveCounter -= 3;
+				m_skeletonEndPoints[id] = QPair<QVector3D,QVector3D>(coordsA, coordsB);
+
+			}
+		}
+		else {
+			m_skeletonEntities[id] = addJoint(coordsA, coordsB, m_skeletonThickness, QColor(150, 150, 150));
+			m_skeletonEndPoints[id] = QPair<QVector3D,QVector3D>(coordsA, coordsB);
+			adjustView();
+			m_camMoveCounter -= 3;
+		}
+	}
+	else {
+		if (m_skeletonEntities[id] != nullptr) {
+			m_skeletonEntities[id]->deleteLater();
+			m_skeletonEntities[id] = nullptr;
+			adjustView();
+			m_camMoveCounter -= 3;
+		}
+	}
+}
+
 void ViewPort::toggleCamerasSlot(bool toggle) {
 	for (const auto & camera : m_cameraList) {
 		camera->setEnabled(toggle);
@@ -353,6 +422,7 @@ void ViewPort::toggleViewAdjustSlot(bool toggle) {
 void ViewPort::setKeypointRadiusSlot(int radius) {
 	m_keypointRadius = radius;
 	for (auto &keypoint : m_keypointEntities) {
+		if (keypoint == nullptr) continue;
 		Qt3DExtras::QSphereMesh *mesh = keypoint->componentsOfType<Qt3DExtras::QSphereMesh>()[0];
 		mesh->setRadius(radius);
 	}
@@ -361,6 +431,7 @@ void ViewPort::setKeypointRadiusSlot(int radius) {
 void ViewPort::setSkeletonThicknessSlot(int thickness) {
 	m_skeletonThickness = thickness;
 	for (auto &joint : m_skeletonEntities) {
+		if (joint == nullptr) continue;
 		Qt3DExtras::QCylinderMesh *mesh = joint->componentsOfType<Qt3DExtras::QCylinderMesh>()[0];
 		mesh->setRadius(thickness);
 	}
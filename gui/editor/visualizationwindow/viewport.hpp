@@ -49,8 +49,9 @@ class ViewPort : public QWidget
 		explicit ViewPort(QWidget *parent = nullptr);
 
         void reset();
-        void setCoords3D(QMap<QString, QVector3D> coords3D) {m_coords3D = coords3D;}
-		QMap<QString, QVector3D> coords3D() {return m_coords3D;}
+        void setCoords3D(const KeypointCoords3D& coords3D) {m_coords3D = coords3D;}
+		void setCoord3D(int keypointId, const QVector3D& coord3D, bool valid);
+		const KeypointCoords3D& coords3D() const {return m_coords3D;}
 		QVector3D center() {return m_center;}
 		void addCamera(QVector3D position, QVector3D pointingVector, QVector3D upVector);
 		void addSetup(QList<QVector3D> coords, float cornerRadius, QColor cornerColor, QColor floorColor, float alpha = 1.0, bool addFloor = true);
@@ -82,8 +83,9 @@ class ViewPort : public QWidget
 		Qt3DCore::QEntity *setupEntity;
 
 
-		QMap<QString, QVector3D> m_coords3D;
+		KeypointCoords3D m_coords3D;
 		QVector3D m_center;
+		int m_centerCount = 0;
 		
 		bool m_setupVisible = true;
 		bool m_camerasVisible = true;
@@ -96,9 +98,9 @@ class ViewPort : public QWidget
 		Qt3DRender::QCamera *camera;
 
 		int m_camMoveCounter = 0;
-		QMap<QString, Qt3DCore::QEntity*> m_keypointEntities;
-		QMap<QString, Qt3DCore::QEntity *> m_skeletonEntities;
-		QMap<QString, QPair<QVector3D, QVector3D>> m_skeletonEndPoints;
+		QList<Qt3DCore::QEntity*> m_keypointEntities;			//[keypointId]
+		QList<Qt3DCore::QEntity *> m_skeletonEntities;		//[entityIndex][bone]
+		QList<QPair<QVector3D, QVector3D>> m_skeletonEndPoints;
 		QMap<QString, Qt3DCore::QEntity*> m_setupKeypoints;
 		Qt3DCore::QEntity* m_floor = nullptr;
 		QList<Qt3DCore::QEntity*> m_cameraList;
@@ -109,6 +111,9 @@ class ViewPort : public QWidget
 		void drawCamera(QVector3D position, QVector3D pointingVector, QVector3D upVector);
 		void drawCameras();
 		void adjustView();
+		bool hasCoords(int id) const;
+		void updateKeypointEntity(int id);
+		void updateBoneEntity(int entity, int boneIndex);
 
 		private slots: 
 };
@@ -62,12 +62,18 @@ void VisualizationWindow::viewInitSlot() {
 
 
 
-void VisualizationWindow::update3DCoordsSlot(QMap<QString, QVector3D> coords3D)
+void VisualizationWindow::update3DCoordsSlot(const KeypointCoords3D& coords3D)
 {
 	viewPort->setCoords3D(coords3D);
 	viewPort->update();
 }
 
+void VisualizationWindow::update3DCoordSlot(int keypointId,
+			const QVector3D& coord3D, bool valid)
+{
+	viewPort->setCoord3D(keypointId, coord3D, valid);
+}
+
 void VisualizationWindow::reprojectionToolUpdatedSlot(ReprojectionTool *reproTool) 
 {
 	viewPort->reset();
@@ -135,12 +141,12 @@ void VisualizationWindow::saveClickedSlot() {
 	if (saveFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
 		QTextStream out(&saveFile);
 		out << "Entity" << ","<< "Keypoint" << "," << "x" << "," << "y" << "," << "z" << "\n";
-		auto coords3D = viewPort->coords3D();
-		for (const auto & id : coords3D.keys()) {
-			float x = coords3D[id][0];
-			float y = coords3D[id][1];
-			float z = coords3D[id][2];
-			out << id.split("/")[0] << "," << id.split("/")[1] << "," << x << "," << y << "," << z << "\n";
+		const KeypointCoords3D& coords3D = viewPort->coords3D();
+		KeypointStore *store = Dataset::dataset->keypointStore();
+		for (int id = 0; id < coords3D.coords.size(); id++) {
+			if (!coords3D.valid[id]) continue;
+			const QVector3D& coord = coords3D.coords[id];
+			out << store->entity(id) << "," << store->bodypart(id) << "," << coord.x() << "," << coord.y() << "," << coord.z() << "\n";
 		}
 	}
 	else {
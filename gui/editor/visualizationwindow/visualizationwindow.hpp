@@ -43,7 +43,9 @@ class VisualizationWindow : public QMainWindow
 	signals:
 
 	public slots:
-		void update3DCoordsSlot(QMap<QString, QVector3D> coords3D);
+		void update3DCoordsSlot(const KeypointCoords3D& coords3D);
+		void update3DCoordSlot(int keypointId, const QVector3D& coord3D,
+					bool valid);
 		void reprojectionToolUpdatedSlot(ReprojectionTool *reproTool);
 		void saveClickedSlot();
 
@@ -9,6 +9,7 @@
 
 #include "datasetlist.hpp"
 #include "segmentselectorwindow.hpp"
+#include "annotationcontainer.hpp"
 
 #include <QGridLayout>
 #include <QLineEdit>
@@ -145,26 +146,27 @@ bool DatasetList::analyseDatasetPath(DatasetExportItem * exportItem, const QStri
 
 bool DatasetList::getDatasetDirInfo(DatasetExportItem * exportItem, const QString &path) {
 	QList<QString> cameraPaths = QDir(path).entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
+	DatasetIndex index(exportItem->basePath, path);
+	index.load();
 	for (const auto &cameraPath : cameraPaths) {
-		QFile *file = new QFile(path + "/" + cameraPath + "/annotations.csv");
-		if (!file->open(QIODevice::ReadOnly)) {
+		QList<DatasetIndex::KeypointCount> counts;
+		int frameCount;
+		if (!getKeypointCounts(index, path + "/" + cameraPath, &counts, &frameCount)) {
 			return false;
 		}
-		file->readLine(); //Scorer
 
-		QList<QByteArray> entities = file->readLine().split(',');
 		QList<QString> entityNames;
 		for (const auto & entity : m_entities) {
 			entityNames.append(entity.first);
 		}
 		//if (m_entities.size() == 0) {
-			for (int i = 1; i < entities.size(); i+= 3) {
-				if(!entityNames.contains(entities[i])) {
+			for (const auto & count : counts) {
+				if(!entityNames.contains(count.entity)) {
 					QPair<QString, bool> newEntity;
-					newEntity.first = entities[i];
+					newEntity.first = count.entity;
 					newEntity.second = true;
 					m_entities.append(newEntity);
-					entityNames.append(entities[i]);
+					entityNames.append(count.entity);
 				}
 			}
 	//	}
@@ -179,45 +181,36 @@ bool DatasetList::getDatasetDirInfo(DatasetExportItem * exportItem, const QStrin
 		// 	}
 		// }
 
-		QList<QByteArray> keypoints = file->readLine().split(',');
 		QList<QString> keypointNames;
 		for (const auto & keypoint : m_keypoints) {
 			keypointNames.append(keypoint.first);
 		}
 		if (m_keypoints.size() == 0) {
-			for (int i = 1; i < keypoints.size(); i+= 3) {
-				if(!keypointNames.contains(keypoints[i])) {
+			for (const auto & count : counts) {
+				if(!keypointNames.contains(count.bodypart)) {
 					QPair<QString, bool> newKeypoint;
-					newKeypoint.first = keypoints[i];
+					newKeypoint.first = count.bodypart;
 					newKeypoint.second = true;
 					m_keypoints.append(newKeypoint);
-					keypointNames.append(keypoints[i]);
+					keypointNames.append(count.bodypart);
 				}
 			}
 		}
 		else {
 			QList<QString> testKeypoints;
-			for (int i = 1; i < keypoints.size(); i+= 3) {
-				if(!testKeypoints.contains(keypoints[i])) testKeypoints.append(keypoints[i]);
+			for (const auto & count : counts) {
+				if(!testKeypoints.contains(count.bodypart)) testKeypoints.append(count.bodypart);
 			}
 			if (testKeypoints != keypointNames) {
-				file->close();
 				return false;
 			}
 		}
-		file->readLine(); //Coords
-		while (!file->atEnd()) {
-			exportItem->frameCount++;
-			QList<QByteArray> cells = file->readLine().split(',');
-			for (int i = 3; i < cells.size(); i += 3) {
-				KeypointState state = static_cast<KeypointState>(cells[i].toInt());
-				if (state == Annotated) exportItem->annotationCount.annotated++;
-				else if (state == Reprojected) exportItem->annotationCount.reprojected++;
-				else if (state == NotAnnotated) exportItem->annotationCount.notAnnotated++;
-			}
+		exportItem->frameCount += frameCount;
+		for (const auto & count : counts) {
+			exportItem->annotationCount = exportItem->annotationCount + count.count;
 		}
-		file->close();
 	}
+	if (index.isModified()) index.save();
 	return true;
 }
 
@@ -226,50 +219,62 @@ void DatasetList::updateCounts(DatasetExportItem &exportItem) {
 	exportItem.annotationCount.reprojected = 0;
 	exportItem.annotationCount.notAnnotated = 0;
 	exportItem.frameCount = 0;
+	QList<QString> entityNames;
+	for (const auto & entity : m_entities) {
+		entityNames.append(entity.first);
+	}
+	QList<QString> keypointNames;
+	for (const auto & keypoint : m_keypoints) {
+		keypointNames.append(keypoint.first);
+	}
 	for (const auto &subSet : exportItem.subSets) {
 		if (subSet.second) {
-			QList<QString> cameraPaths = QDir(exportItem.basePath + "/" + subSet.first).entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
+			QString segmentPath = exportItem.basePath + "/" + subSet.first;
+			QList<QString> cameraPaths = QDir(segmentPath).entryList(QDir::AllDirs | QDir::NoDotAndDotDot);
+			DatasetIndex index(exportItem.basePath, segmentPath);
+			index.load();
 			for (const auto &cameraPath : cameraPaths) {
-				QFile *file = new QFile(exportItem.basePath + "/" + subSet.first + "/" + cameraPath + "/annotations.csv");
-				if (!file->open(QIODevice::ReadOnly)) {
+				QList<DatasetIndex::KeypointCount> counts;
+				int frameCount;
+				if (!getKeypointCounts(index, segmentPath + "/" + cameraPath, &counts,
+							&frameCount)) {
 					return;
 				}
-				file->readLine(); //Scorer
-				QList<QByteArray> entities = file->readLine().split(',');
-				QList<QString> entityNames;
-				for (const auto & entity : m_entities) {
-					entityNames.append(entity.first);
-				}
-				QList<QByteArray> keypoints = file->readLine().split(',');
-				QList<QString> keypointNames;
-				for (const auto & keypoint : m_keypoints) {
-					keypointNames.append(keypoint.first);
-				}
-
-				file->readLine(); //Coords
-				while (!file->atEnd()) {
-					exportItem.frameCount++;
-					QList<QByteArray> cells = file->readLine().split(',');
-					for (int i = 3; i < cells.size(); i += 3) {
-						int entityIndex = entityNames.indexOf(entities[i]);
-						int keypointIndex = keypointNames.indexOf(keypoints[i]);
-						if (entityIndex != -1 && m_entities[entityIndex].second) {
-							if (keypointIndex != -1 && m_keypoints[keypointIndex].second) {
-								KeypointState state = static_cast<KeypointState>(cells[i].toInt());
-								if (state == Annotated) exportItem.annotationCount.annotated++;
-								else if (state == Reprojected) exportItem.annotationCount.reprojected++;
-								else if (state == NotAnnotated) exportItem.annotationCount.notAnnotated++;
-							}
+				exportItem.frameCount += frameCount;
+				for (const auto & count : counts) {
+					int entityIndex = entityNames.indexOf(count.entity);
+					int keypointIndex = keypointNames.indexOf(count.bodypart);
+					if (entityIndex != -1 && m_entities[entityIndex].second) {
+						if (keypointIndex != -1 && m_keypoints[keypointIndex].second) {
+							exportItem.annotationCount = exportItem.annotationCount + count.count;
 						}
 					}
 				}
-				file->close();
 			}
+			if (index.isModified()) index.save();
 		}
 	}
 	emit itemsChanged();
 }
 
+
+bool DatasetList::getKeypointCounts(DatasetIndex &index, const QString &cameraPath,
+			QList<DatasetIndex::KeypointCount> *counts, int *frameCount) {
+	QString cameraName = QFileInfo(cameraPath).fileName();
+	if (index.keypointCounts(cameraName, counts, frameCount)) {
+		return true;
+	}
+	//Only read the annotations if the index doesn't know them yet
+	AnnotationContainer container(cameraPath);
+	if (!container.open(AnnotationContainer::ReadOnly)) {
+		return false;
+	}
+	*counts = DatasetIndex::countKeypoints(container);
+	*frameCount = container.numRows();
+	index.setKeypointCounts(cameraName, *counts, *frameCount);
+	return true;
+}
+
 void DatasetList::removeItemSlot() {
 	int row = itemSelectorList->currentRow();
 	if (row != -1) {
@@ -11,6 +11,7 @@
 #define DATASETLIST_H
 
 #include "globals.hpp"
+#include "datasetindex.hpp"
 
 #include <QPushButton>
 #include <QTableWidget>
@@ -57,6 +58,8 @@ class DatasetList : public QWidget {
 		bool getDatasetDirInfo(DatasetExportItem * exportItem, const QString &path);
 		void addListItem(const QString &text);
 		void updateCounts(DatasetExportItem &exportItem);
+		bool getKeypointCounts(DatasetIndex &index, const QString &cameraPath,
+					QList<DatasetIndex::KeypointCount> *counts, int *frameCount);
 
 	private slots:
 		void itemSelectedSlot(QListWidgetItem *item);
@@ -15,6 +15,7 @@
 #include <QStackedWidget>
 #include <QStatusBar>
 #include <QMenuBar>
+#include <QShortcut>
 
 //This is a global funciton, probably not ideal to have it here
 void createToolBarButton(QToolButton *button, QAction*action, QIcon icon,
@@ -36,6 +37,10 @@ MainWindow::MainWindow(QMainWindow *parent) : QMainWindow(parent) {
 	statusBar()->showMessage(tr("Ready"), 2000);
 
 	settingsWindow = new SettingsWindow(this);
+	profilerWindow = new ProfilerWindow(this);
+	QShortcut *profilerShortcut = new QShortcut(QKeySequence("Ctrl+Shift+P"), this);
+	connect(profilerShortcut, &QShortcut::activated,
+					this, &MainWindow::openProfilerWindowSlot);
 
 	mainBar = new MainBar(this);
 	this->addToolBar(mainBar);
@@ -154,6 +159,8 @@ MainWindow::MainWindow(QMainWindow *parent) : QMainWindow(parent) {
 					editorWidget, &EditorWidget::errorThresholdChanged);
 	connect(settingsWindow, &SettingsWindow::boneLengthErrorThresholdChanged,
 					editorWidget, &EditorWidget::boneLengthErrorThresholdChanged);
+	connect(settingsWindow, &SettingsWindow::outlierThresholdChanged,
+					editorWidget, &EditorWidget::outlierThresholdChanged);
 	connect(editorWidget, &EditorWidget::brightnessChanged, settingsWindow, &SettingsWindow::brightnessChangedSlot);
 	connect(editorWidget, &EditorWidget::datasetLoaded,
 					settingsWindow, &SettingsWindow::datasetLoadedSlot);
@@ -166,6 +173,12 @@ void MainWindow::openSettingsWindowSlot() {
 }
 
 
+void MainWindow::openProfilerWindowSlot() {
+	profilerWindow->show();
+	profilerWindow->raise();
+}
+
+
 void MainWindow::loadDatasetClickedSlot() {
 	loadDatasetWindow->exec();
 }
@@ -182,6 +195,10 @@ void MainWindow::newCalibrationClickedSlot() {
 
 
 void MainWindow::exportTrainingsetClickedSlot() {
+	//Exports and annotation counts are read from the csvs
+	if (Dataset::dataset != nullptr) {
+		Dataset::dataset->flush();
+	}
 	stackedWidget->setCurrentWidget(exportTrainingsetWidget);
 }
 
@@ -199,7 +216,7 @@ void MainWindow::quitClickedSlot() {
 
 void MainWindow::exitToMainPageSlot() {
 	if (stackedWidget->currentWidget() == editorWidget) {
-		Dataset::dataset->save();
+		Dataset::dataset->flush();
 	}
 	stackedWidget->setCurrentWidget(datasetWidget);
 }
@@ -13,6 +13,7 @@
 #include "globals.hpp"
 #include "mainbar.hpp"
 #include "settingswindow.hpp"
+#include "profilerwindow.hpp"
 #include "loaddatasetwindow.hpp"
 #include "newdatasetwindow.hpp"
 #include "newcalibrationwidget.hpp"
@@ -31,10 +32,12 @@ class MainWindow : public QMainWindow {
 
 	public slots:
 		void openSettingsWindowSlot();
+		void openProfilerWindowSlot();
 		void quitClickedSlot();
 
 	private:
 		SettingsWindow *settingsWindow;
+		ProfilerWindow *profilerWindow;
 
 		MainBar *mainBar;
 		QStackedWidget *stackedWidget;
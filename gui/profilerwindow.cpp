@@ -0,0 +1,142 @@
+/*******************************************************************************
+ * File:			  profilerwindow.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "profilerwindow.hpp"
+#include "imagecache.hpp"
+
+#include <QDir>
+#include <QErrorMessage>
+#include <QFileDialog>
+#include <QGridLayout>
+#include <QHeaderView>
+
+
+ProfilerWindow::ProfilerWindow(QWidget *parent) : QWidget(parent, Qt::Window) {
+	this->resize(600,400);
+	this->setMinimumSize(450,250);
+	setWindowTitle("Profiler");
+	QGridLayout *layout = new QGridLayout(this);
+
+	QLabel *lastSamplesLabel = new QLabel("Samples per Stage");
+	lastSamplesEdit = new QSpinBox(this);
+	lastSamplesEdit->setRange(10, Profiler::Capacity);
+	lastSamplesEdit->setValue(200);
+	connect(lastSamplesEdit, QOverload<int>::of(&QSpinBox::valueChanged),
+				this, &ProfilerWindow::refreshSlot);
+
+	stageTable = new QTableWidget(0, 5, this);
+	stageTable->setHorizontalHeaderLabels({"Stage", "Count", "p50 [ms]",
+				"p95 [ms]", "max [ms]"});
+	stageTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+	stageTable->verticalHeader()->hide();
+	stageTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	stageTable->setSelectionMode(QAbstractItemView::NoSelection);
+
+	imageCacheLabel = new QLabel(this);
+
+	QWidget *buttonWidget = new QWidget(this);
+	QGridLayout *buttonlayout = new QGridLayout(buttonWidget);
+	buttonlayout->setContentsMargins(0,0,0,0);
+	clearButton = new QPushButton("Clear", buttonWidget);
+	clearButton->setMinimumSize(30,30);
+	connect(clearButton, &QPushButton::clicked, this, &ProfilerWindow::clearClickedSlot);
+	exportCSVButton = new QPushButton("Export CSV", buttonWidget);
+	exportCSVButton->setMinimumSize(30,30);
+	connect(exportCSVButton, &QPushButton::clicked, this, &ProfilerWindow::exportCSVClickedSlot);
+	exportTraceButton = new QPushButton("Export Trace", buttonWidget);
+	exportTraceButton->setMinimumSize(30,30);
+	connect(exportTraceButton, &QPushButton::clicked, this, &ProfilerWindow::exportTraceClickedSlot);
+	buttonlayout->addWidget(clearButton,0,0);
+	buttonlayout->addWidget(exportCSVButton,0,1);
+	buttonlayout->addWidget(exportTraceButton,0,2);
+
+	layout->addWidget(lastSamplesLabel,0,0);
+	layout->addWidget(lastSamplesEdit,0,1);
+	layout->addWidget(stageTable,1,0,1,2);
+	layout->addWidget(imageCacheLabel,2,0,1,2);
+	layout->addWidget(buttonWidget,3,0,1,2);
+
+	refreshTimer = new QTimer(this);
+	refreshTimer->setInterval(500);
+	connect(refreshTimer, &QTimer::timeout, this, &ProfilerWindow::refreshSlot);
+}
+
+
+void ProfilerWindow::showEvent(QShowEvent *event) {
+	QWidget::showEvent(event);
+	refreshSlot();
+	refreshTimer->start();
+}
+
+
+void ProfilerWindow::hideEvent(QHideEvent *event) {
+	QWidget::hideEvent(event);
+	refreshTimer->stop();
+}
+
+
+void ProfilerWindow::refreshSlot() {
+	QList<Profiler::StageStatistics> statistics =
+				Profiler::instance()->statistics(lastSamplesEdit->value());
+	stageTable->setRowCount(statistics.size());
+	for (int row = 0; row < statistics.size(); row++) {
+		const Profiler::StageStatistics& stage = statistics[row];
+		QList<QString> values = {stage.name, QString::number(stage.count),
+					QString::number(stage.p50, 'f', 2), QString::number(stage.p95, 'f', 2),
+					QString::number(stage.max, 'f', 2)};
+		for (int column = 0; column < values.size(); column++) {
+			QTableWidgetItem *item = stageTable->item(row, column);
+			if (item == nullptr) {
+				item = new QTableWidgetItem();
+				if (column > 0) item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+				stageTable->setItem(row, column, item);
+			}
+			item->setText(values[column]);
+		}
+	}
+
+	ImageCache::Statistics cache = ImageCache::instance()->statistics();
+	qint64 requests = cache.hits + cache.misses;
+	imageCacheLabel->setText(QString("Image cache: %1 images, %2 / %3 MB, "
+				"hit rate %4 %, %5 prefetched")
+				.arg(cache.numImages)
+				.arg(cache.usedBytes/(1024*1024))
+				.arg(cache.budgetBytes/(1024*1024))
+				.arg(requests > 0 ? 100.0*cache.hits/requests : 0.0, 0, 'f', 1)
+				.arg(cache.prefetched));
+}
+
+
+void ProfilerWindow::clearClickedSlot() {
+	Profiler::instance()->clear();
+	ImageCache::instance()->resetStatistics();
+	refreshSlot();
+}
+
+
+void ProfilerWindow::exportCSVClickedSlot() {
+	QString path = QFileDialog::getSaveFileName(this, "Export Samples",
+				QDir::homePath() + "/profile.csv", "CSV Files (*.csv)");
+	if (path.isEmpty()) return;
+	if (!Profiler::instance()->exportCSV(path)) {
+		QErrorMessage *msg = new QErrorMessage(this);
+		msg->showMessage("Could not write " + path);
+	}
+}
+
+
+void ProfilerWindow::exportTraceClickedSlot() {
+	QString path = QFileDialog::getSaveFileName(this, "Export Trace",
+				QDir::homePath() + "/profile.json", "Trace Files (*.json)");
+	if (path.isEmpty()) return;
+	if (!Profiler::instance()->exportChromeTrace(path)) {
+		QErrorMessage *msg = new QErrorMessage(this);
+		msg->showMessage("Could not write " + path);
+	}
+}
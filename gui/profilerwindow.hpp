@@ -0,0 +1,50 @@
+/*******************************************************************************
+ * File:			  profilerwindow.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef PROFILERWINDOW_H
+#define PROFILERWINDOW_H
+
+#include "globals.hpp"
+#include "profiler.hpp"
+
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QTimer>
+
+
+// Debug panel listing p50/p95/max latency of every profiled stage over the
+// samples currently held by the Profiler. Opened with Ctrl+Shift+P.
+class ProfilerWindow : public QWidget {
+	Q_OBJECT
+
+	public:
+		explicit ProfilerWindow(QWidget *parent = nullptr);
+
+	private:
+		void showEvent(QShowEvent *event) override;
+		void hideEvent(QHideEvent *event) override;
+
+		QTableWidget *stageTable;
+		QLabel *imageCacheLabel;
+		QSpinBox *lastSamplesEdit;
+		QPushButton *clearButton;
+		QPushButton *exportCSVButton;
+		QPushButton *exportTraceButton;
+		QTimer *refreshTimer;
+
+	private slots:
+		void refreshSlot();
+		void clearClickedSlot();
+		void exportCSVClickedSlot();
+		void exportTraceClickedSlot();
+};
+
+#endif
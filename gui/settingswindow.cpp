@@ -98,6 +98,15 @@ SettingsWindow::SettingsWindow(QWidget *parent) : QWidget(parent, Qt::Window) {
 		connect(contrastResetButton, &QPushButton::clicked,
 						this, &SettingsWindow::contrastResetClickedSlot);
 
+	QLabel *cacheSizeLabel = new QLabel("Image Cache Size (MB)");
+	cacheSizeEdit = new QSpinBox(imageSettingsWidget);
+	cacheSizeEdit->setRange(64,65536);
+	cacheSizeEdit->setSingleStep(256);
+	cacheSizeEdit->setValue(ImageCache::DefaultBudgetMB);
+	cacheSizeEdit->setMinimumSize(80,30);
+	connect(cacheSizeEdit, QOverload<int>::of(&QSpinBox::valueChanged),
+					this, &SettingsWindow::cacheSizeChangedSlot);
+
 	QWidget *imageSpacer = new QWidget();
 	imageSpacer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
@@ -119,7 +128,9 @@ SettingsWindow::SettingsWindow(QWidget *parent) : QWidget(parent, Qt::Window) {
 	imagesettingslayout->addWidget(contrastSlider,4,1);
 	imagesettingslayout->addWidget(contrastBox,4,2);
 	imagesettingslayout->addWidget(contrastResetButton,4,3);
-	imagesettingslayout->addWidget(imageSpacer,5,0,1,3);
+	imagesettingslayout->addWidget(cacheSizeLabel,5,0);
+	imagesettingslayout->addWidget(cacheSizeEdit,5,2);
+	imagesettingslayout->addWidget(imageSpacer,6,0,1,3);
 
 
 
@@ -197,6 +208,15 @@ SettingsWindow::SettingsWindow(QWidget *parent) : QWidget(parent, Qt::Window) {
 	connect(boneLengthErrorThresholdEdit,
 					QOverload<double>::of(&QDoubleSpinBox::valueChanged),
 					this, &SettingsWindow::boneLengthErrorThresholdChangedSlot);
+	QLabel *outlierThresholdLabel = new QLabel("Outlier View Threshold");
+	outlierThresholdEdit = new QDoubleSpinBox();
+	outlierThresholdEdit->setRange(0.0, 500.0);
+	outlierThresholdEdit->setSpecialValueText("Off");
+	outlierThresholdEdit->setSuffix(" px");
+	outlierThresholdEdit->setValue(0.0);
+	connect(outlierThresholdEdit,
+					QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+					this, &SettingsWindow::outlierThresholdChangedSlot);
 	QWidget *reproSpacer = new QWidget();
 	reproSpacer->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 	
@@ -206,7 +226,9 @@ SettingsWindow::SettingsWindow(QWidget *parent) : QWidget(parent, Qt::Window) {
 	reprojectionsettingslayout->addWidget(errorThresholdEdit,1,1);
 	reprojectionsettingslayout->addWidget(boneLengthErrorThresholdLabel,2,0);
 	reprojectionsettingslayout->addWidget(boneLengthErrorThresholdEdit,2,1);
-	reprojectionsettingslayout->addWidget(reproSpacer,3,0,1,2);
+	reprojectionsettingslayout->addWidget(outlierThresholdLabel,3,0);
+	reprojectionsettingslayout->addWidget(outlierThresholdEdit,3,1);
+	reprojectionsettingslayout->addWidget(reproSpacer,4,0,1,2);
 
 	infoWidget = new QWidget();
     QLabel *versionLabel = new QLabel("Version:");
@@ -360,6 +382,11 @@ void SettingsWindow::loadSettings() {
 		backgroundColorPreview->setPixmap(QPixmap::fromImage(backgroundColorImage).scaled(200, 20));
 	}
 	settings->endGroup();
+	settings->beginGroup("ImageSettings");
+	if (settings->contains("cacheSize")) {
+		cacheSizeEdit->setValue(settings->value("cacheSize").toInt());
+	}
+	settings->endGroup();
 	settings->beginGroup("ReprojectionSettings");
 	int minViews = 2;
 	if (settings->contains("MinViews")) {
@@ -380,6 +407,11 @@ void SettingsWindow::loadSettings() {
 	}
 	boneLengthErrorThresholdEdit->setValue(boneLengthErrorThreshold);
 	boneLengthErrorThresholdChanged(boneLengthErrorThreshold);
+	double outlierThreshold = 0.0;
+	if (settings->contains("outlierThreshold")) {
+		outlierThreshold = settings->value("outlierThreshold").toDouble();
+	}
+	outlierThresholdEdit->setValue(outlierThreshold);
 	settings->endGroup();
 	settings->endGroup();
 }
@@ -536,6 +568,16 @@ void SettingsWindow::colorChooserClickedSlot() {
 }
 
 
+void SettingsWindow::cacheSizeChangedSlot(int val) {
+	settings->beginGroup("Settings");
+	settings->beginGroup("ImageSettings");
+	settings->setValue("cacheSize", val);
+	settings->endGroup();
+	settings->endGroup();
+	ImageCache::instance()->setMemoryBudget(static_cast<qint64>(val)*1024*1024);
+}
+
+
 void SettingsWindow::minViewsChangedSlot(int val) {
 	settings->beginGroup("Settings");
 	settings->beginGroup("ReprojectionSettings");
@@ -565,6 +607,16 @@ void SettingsWindow::boneLengthErrorThresholdChangedSlot(double val) {
 	emit boneLengthErrorThresholdChanged(val);
 }
 
+
+void SettingsWindow::outlierThresholdChangedSlot(double val) {
+	settings->beginGroup("Settings");
+	settings->beginGroup("ReprojectionSettings");
+	settings->setValue("outlierThreshold", val);
+	settings->endGroup();
+	settings->endGroup();
+	emit outlierThresholdChanged(val);
+}
+
 void SettingsWindow::brightnessChangedSlot(int brightnessFactor) {
 	brightnessSlider->setValue(brightnessFactor);
 }
\ No newline at end of file
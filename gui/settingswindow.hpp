@@ -13,6 +13,7 @@
 #include "globals.hpp"
 #include "dataset.hpp"
 #include "colormap.hpp"
+#include "imagecache.hpp"
 
 #include <QPushButton>
 #include <QLabel>
@@ -45,6 +46,7 @@ class SettingsWindow : public QWidget {
 		void minViewsChanged(int val);
 		void errorThresholdChanged(float val);
 		void boneLengthErrorThresholdChanged(float val);
+		void outlierThresholdChanged(float val);
 
 	public slots:
 		void datasetLoadedSlot();
@@ -80,6 +82,7 @@ class SettingsWindow : public QWidget {
 		QSlider *contrastSlider;
 		QSpinBox *contrastBox;
 		QPushButton *contrastResetButton;
+		QSpinBox *cacheSizeEdit;
 
 		QWidget *annotationSettingsWidget;
 		QSpinBox *keypointSizeEdit;
@@ -103,6 +106,7 @@ class SettingsWindow : public QWidget {
 		QSpinBox *minViewsEdit;
 		QDoubleSpinBox *errorThresholdEdit;
 		QDoubleSpinBox *boneLengthErrorThresholdEdit;
+		QDoubleSpinBox *outlierThresholdEdit;
 
 		QWidget *infoWidget;
 
@@ -113,6 +117,7 @@ class SettingsWindow : public QWidget {
 		void saturationResetClickedSlot();
 		void brightnessResetClickedSlot();
 		void contrastResetClickedSlot();
+		void cacheSizeChangedSlot(int val);
 		void alwaysShowLabelsToggledSlot(int state);
 		void fontColorChooserButtonClickedSlot();
 		void backgroundColorChooserButtonClickedSlot();
@@ -122,6 +127,7 @@ class SettingsWindow : public QWidget {
 		void minViewsChangedSlot(int val);
 		void errorThresholdChangedSlot(double val);
 		void boneLengthErrorThresholdChangedSlot(double val);
+		void outlierThresholdChangedSlot(double val);
 
 };
 
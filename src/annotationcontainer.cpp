@@ -0,0 +1,539 @@
+/*******************************************************************************
+ * File:			  annotationcontainer.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "annotationcontainer.hpp"
+
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QHash>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QRunnable>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <io.h>
+#else
+#include <sys/mman.h>
+#endif
+
+
+static const char containerMagic[8] = {'J','A','R','V','I','S','A','C'};
+static const quint32 containerVersion = 1;
+//Below this csv size parsing is quick enough that no container is written
+static const qint64 minContainerCsvSize = 1024*1024;
+
+
+static quint64 appendSection(QByteArray &image, const void *data, qint64 size) {
+	while (image.size() % 8) image.append('\0');
+	quint64 offset = image.size();
+	if (size > 0) image.append(static_cast<const char*>(data), size);
+	return offset;
+}
+
+
+// Parses the decimal numbers written by QTextStream (optional sign, digits,
+// fraction and exponent) without allocating, invalid input yields NaN.
+float AnnotationContainer::parseFloat(const char *begin, const char *end) {
+	const char *c = begin;
+	bool negative = false;
+	if (c < end && (*c == '-' || *c == '+')) {
+		negative = (*c == '-');
+		c++;
+	}
+	quint64 mantissa = 0;
+	int exponent = 0;
+	int numDigits = 0;
+	for (; c < end && *c >= '0' && *c <= '9'; c++, numDigits++) {
+		if (mantissa < 100000000000000000ull) mantissa = mantissa*10 + (*c - '0');
+		else exponent++;
+	}
+	if (c < end && *c == '.') {
+		for (c++; c < end && *c >= '0' && *c <= '9'; c++, numDigits++) {
+			if (mantissa < 100000000000000000ull) {
+				mantissa = mantissa*10 + (*c - '0');
+				exponent--;
+			}
+		}
+	}
+	if (numDigits == 0) {
+		return std::numeric_limits<float>::quiet_NaN();
+	}
+	if (c < end && (*c == 'e' || *c == 'E')) {
+		c++;
+		bool negativeExponent = false;
+		if (c < end && (*c == '-' || *c == '+')) {
+			negativeExponent = (*c == '-');
+			c++;
+		}
+		int value = 0;
+		for (; c < end && *c >= '0' && *c <= '9'; c++) {
+			if (value < 10000) value = value*10 + (*c - '0');
+		}
+		exponent += negativeExponent ? -value : value;
+	}
+	if (c != end) {
+		return std::numeric_limits<float>::quiet_NaN();
+	}
+	double result = static_cast<double>(mantissa);
+	if (exponent < 0) result /= std::pow(10.0, -exponent);
+	else if (exponent > 0) result *= std::pow(10.0, exponent);
+	return static_cast<float>(negative ? -result : result);
+}
+
+
+// Opens one container on the thread pool, containers of different cameras
+// share no state.
+class ContainerOpener : public QRunnable {
+	public:
+		ContainerOpener(AnnotationContainer *container,
+					AnnotationContainer::OpenMode mode, bool *success) :
+					m_container(container), m_mode(mode), m_success(success) {}
+		void run() override {
+			*m_success = m_container->open(m_mode);
+		}
+
+	private:
+		AnnotationContainer *m_container;
+		AnnotationContainer::OpenMode m_mode;
+		bool *m_success;
+};
+
+
+bool AnnotationContainer::openAll(const QList<AnnotationContainer*>& containers,
+			OpenMode mode) {
+	QList<bool> success(containers.size(), false);
+	QThreadPool threadPool;
+	for (int i = 0; i < containers.size(); i++) {
+		threadPool.start(new ContainerOpener(containers[i], mode,
+					success.data()+i));
+	}
+	threadPool.waitForDone();
+	return !success.contains(false);
+}
+
+
+AnnotationContainer::AnnotationContainer(const QString& cameraFolder) :
+			m_cameraFolder(cameraFolder) {
+}
+
+
+AnnotationContainer::~AnnotationContainer() {
+	close();
+}
+
+
+QString AnnotationContainer::csvPath(const QString& cameraFolder) {
+	return cameraFolder + "/annotations.csv";
+}
+
+
+QString AnnotationContainer::containerPath(const QString& cameraFolder) {
+	return cameraFolder + "/annotations.bin";
+}
+
+
+bool AnnotationContainer::open(OpenMode mode) {
+	close();
+	if (!QFile::exists(csvPath(m_cameraFolder))) {
+		return false;
+	}
+	m_writable = (mode == ReadWrite);
+	m_file.setFileName(containerPath(m_cameraFolder));
+	if (m_file.exists() && m_file.open(m_writable ? QIODevice::ReadWrite :
+				QIODevice::ReadOnly)) {
+		m_mappedData = m_file.map(0, m_file.size());
+		if (attach(m_mappedData, m_file.size()) && stampMatches()) {
+			return true;
+		}
+		close();
+		m_writable = (mode == ReadWrite);
+	}
+
+	//Container is missing or stale, rebuild it from the csv
+	QByteArray image;
+	if (!importCSV(&image)) {
+		return false;
+	}
+	if (mode == ReadWrite &&
+				QFileInfo(csvPath(m_cameraFolder)).size() >= minContainerCsvSize) {
+		//Renamed over the stale container, other processes that still map the
+		//old one keep reading a file that is never truncated under them
+		QSaveFile file(containerPath(m_cameraFolder));
+		if (file.open(QIODevice::WriteOnly) && file.write(image) == image.size() &&
+					file.commit()) {
+			if (m_file.open(QIODevice::ReadWrite)) {
+				m_mappedData = m_file.map(0, m_file.size());
+				if (attach(m_mappedData, m_file.size())) {
+					return true;
+				}
+			}
+			close();
+		}
+	}
+
+	//Small segment or no writable location, keep the parsed container in
+	//memory. Rows stored in it are never written to disk.
+	m_writable = (mode == ReadWrite);
+	m_ownedData.assign((image.size()+7)/8, 0);
+	std::memcpy(m_ownedData.data(), image.constData(), image.size());
+	return attach(reinterpret_cast<uchar*>(m_ownedData.data()), image.size());
+}
+
+
+void AnnotationContainer::close() {
+	if (m_mappedData != nullptr) {
+		m_file.unmap(m_mappedData);
+		m_mappedData = nullptr;
+	}
+	if (m_file.isOpen()) {
+		m_file.close();
+	}
+	m_ownedData.clear();
+	m_data = nullptr;
+	m_header = nullptr;
+	m_names.clear();
+	m_writable = false;
+}
+
+
+bool AnnotationContainer::attach(uchar *data, qint64 size) {
+	static_assert(sizeof(Header) == 128, "Unexpected container header size");
+	if (data == nullptr || size < static_cast<qint64>(sizeof(Header))) {
+		return false;
+	}
+	Header *header = reinterpret_cast<Header*>(data);
+	if (std::memcmp(header->magic, containerMagic, 8) != 0 ||
+				header->version != containerVersion ||
+				header->fileSize != static_cast<quint64>(size)) {
+		return false;
+	}
+	quint64 numValues = static_cast<quint64>(header->numRows)*header->numKeypoints;
+	if (header->stateOffset + numValues > header->fileSize ||
+				header->xOffset + numValues*sizeof(float) > header->fileSize ||
+				header->yOffset + numValues*sizeof(float) > header->fileSize) {
+		return false;
+	}
+
+	QList<QString> names;
+	names.reserve(header->numNames);
+	quint64 pos = header->namesOffset;
+	for (quint32 i = 0; i < header->numNames; i++) {
+		quint32 length;
+		if (pos + sizeof(length) > header->fileSize) return false;
+		std::memcpy(&length, data + pos, sizeof(length));
+		pos += sizeof(length);
+		if (pos + length > header->fileSize) return false;
+		names.append(QString::fromUtf8(reinterpret_cast<const char*>(data + pos), length));
+		pos += length;
+	}
+	m_names = names;
+	m_data = data;
+	m_header = header;
+	return true;
+}
+
+
+bool AnnotationContainer::stampMatches() const {
+	QFileInfo csvInfo(csvPath(m_cameraFolder));
+	return csvInfo.exists() && m_header->csvSize == csvInfo.size() &&
+				m_header->csvModified == csvInfo.lastModified().toMSecsSinceEpoch();
+}
+
+
+void AnnotationContainer::updateCsvStamp() {
+	if (m_header == nullptr || !m_writable) return;
+	QFileInfo csvInfo(csvPath(m_cameraFolder));
+	m_header->csvSize = csvInfo.size();
+	m_header->csvModified = csvInfo.lastModified().toMSecsSinceEpoch();
+	sync();
+}
+
+
+bool AnnotationContainer::sync() {
+	if (m_mappedData == nullptr || !m_writable) return true;
+#ifdef Q_OS_WIN
+	return FlushViewOfFile(m_mappedData, 0) &&
+				FlushFileBuffers(reinterpret_cast<HANDLE>(_get_osfhandle(m_file.handle())));
+#else
+	return msync(m_mappedData, m_header->fileSize, MS_SYNC) == 0;
+#endif
+}
+
+
+bool AnnotationContainer::importCSV(QByteArray *image) const {
+	QFileInfo csvInfo(csvPath(m_cameraFolder));
+	QFile file(csvPath(m_cameraFolder));
+	if (!file.open(QIODevice::ReadOnly)) {
+		return false;
+	}
+	//Parse straight from the mapped file, only fall back to reading it into
+	//memory where mapping is not possible
+	QByteArray fileData;
+	const char *data = nullptr;
+	qint64 size = file.size();
+	uchar *mappedCSV = size > 0 ? file.map(0, size) : nullptr;
+	if (mappedCSV != nullptr) {
+		data = reinterpret_cast<const char*>(mappedCSV);
+	}
+	else {
+		fileData = file.readAll();
+		data = fileData.constData();
+		size = fileData.size();
+	}
+	const char *end = data + size;
+
+	QList<QByteArray> names;
+	QHash<QByteArray, quint32> nameIndices;
+	auto intern = [&](const char *begin, const char *cellEnd) -> quint32 {
+		QByteArray name(begin, cellEnd-begin);
+		auto it = nameIndices.constFind(name);
+		if (it != nameIndices.constEnd()) return it.value();
+		quint32 index = names.size();
+		names.append(name);
+		nameIndices.insert(name, index);
+		return index;
+	};
+	auto lineEnd = [&](const char *pos) -> const char* {
+		const char *newline = static_cast<const char*>(
+					std::memchr(pos, '\n', end-pos));
+		return newline != nullptr ? newline : end;
+	};
+	auto cellEnd = [](const char *pos, const char *lineEnd) -> const char* {
+		const char *comma = static_cast<const char*>(
+					std::memchr(pos, ',', lineEnd-pos));
+		return comma != nullptr ? comma : lineEnd;
+	};
+	auto trimCR = [](const char *begin, const char *lineEnd) -> const char* {
+		return (lineEnd > begin && lineEnd[-1] == '\r') ? lineEnd-1 : lineEnd;
+	};
+
+	//Scorer, entities, bodyparts and coords rows
+	const char *pos = data;
+	QList<QList<QPair<const char*, const char*>>> headerRows;
+	for (int i = 0; i < 4; i++) {
+		if (pos >= end) {
+			if (mappedCSV != nullptr) file.unmap(mappedCSV);
+			return false;
+		}
+		const char *next = lineEnd(pos);
+		const char *last = trimCR(pos, next);
+		QList<QPair<const char*, const char*>> cells;
+		const char *cell = pos;
+		while (true) {
+			const char *cellStop = cellEnd(cell, last);
+			cells.append({cell, cellStop});
+			if (cellStop == last) break;
+			cell = cellStop+1;
+		}
+		headerRows.append(cells);
+		pos = next < end ? next+1 : end;
+	}
+	int numKeypoints = (headerRows[2].size()-1)/3;
+	int numColumns = 3*numKeypoints+1;
+	std::vector<quint32> headerCells(4*numColumns);
+	for (int row = 0; row < 4; row++) {
+		for (int column = 0; column < numColumns; column++) {
+			QPair<const char*, const char*> cell = headerRows[row].value(column,
+						{nullptr, nullptr});
+			headerCells[row*numColumns+column] = intern(cell.first, cell.second);
+		}
+	}
+
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	std::vector<quint32> frameNames;
+	std::vector<qint64> rowOffsets;
+	std::vector<float> xs, ys;
+	std::vector<uint8_t> states;
+	size_t estimatedRows = (end-pos)/(numColumns*3+16) + 1;
+	frameNames.reserve(estimatedRows);
+	rowOffsets.reserve(estimatedRows+1);
+	xs.reserve(estimatedRows*numKeypoints);
+	ys.reserve(estimatedRows*numKeypoints);
+	states.reserve(estimatedRows*numKeypoints);
+	while (pos < end) {
+		const char *next = lineEnd(pos);
+		const char *last = trimCR(pos, next);
+		const char *rowStart = pos;
+		pos = next < end ? next+1 : end;
+		if (last == rowStart) continue;
+		rowOffsets.push_back(rowStart-data);
+		const char *cell = rowStart;
+		const char *cellStop = cellEnd(cell, last);
+		frameNames.push_back(intern(cell, cellStop));
+		for (int i = 0; i < numKeypoints; i++) {
+			float values[2] = {nan, nan};
+			for (int j = 0; j < 2; j++) {
+				cell = cellStop < last ? cellStop+1 : last;
+				cellStop = cellEnd(cell, last);
+				if (cell != cellStop) values[j] = parseFloat(cell, cellStop);
+			}
+			cell = cellStop < last ? cellStop+1 : last;
+			cellStop = cellEnd(cell, last);
+			int state = 0;
+			for (const char *c = cell; c < cellStop && *c >= '0' && *c <= '9'; c++) {
+				state = state*10 + (*c - '0');
+			}
+			xs.push_back(values[0]);
+			ys.push_back(values[1]);
+			states.push_back(static_cast<uint8_t>(state));
+		}
+	}
+	rowOffsets.push_back(end-data);
+	if (mappedCSV != nullptr) file.unmap(mappedCSV);
+	file.close();
+
+	QByteArray nameTable;
+	for (const auto& name : names) {
+		quint32 length = name.size();
+		nameTable.append(reinterpret_cast<const char*>(&length), sizeof(length));
+		nameTable.append(name);
+	}
+
+	Header header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, containerMagic, 8);
+	header.version = containerVersion;
+	header.numRows = frameNames.size();
+	header.numKeypoints = numKeypoints;
+	header.numNames = names.size();
+	header.csvSize = csvInfo.size();
+	header.csvModified = csvInfo.lastModified().toMSecsSinceEpoch();
+
+	image->clear();
+	image->append(reinterpret_cast<const char*>(&header), sizeof(header));
+	header.namesOffset = appendSection(*image, nameTable.constData(), nameTable.size());
+	header.headerCellsOffset = appendSection(*image, headerCells.data(),
+				headerCells.size()*sizeof(quint32));
+	header.frameNamesOffset = appendSection(*image, frameNames.data(),
+				frameNames.size()*sizeof(quint32));
+	header.rowOffsetsOffset = appendSection(*image, rowOffsets.data(),
+				rowOffsets.size()*sizeof(qint64));
+	header.xOffset = appendSection(*image, xs.data(), xs.size()*sizeof(float));
+	header.yOffset = appendSection(*image, ys.data(), ys.size()*sizeof(float));
+	header.stateOffset = appendSection(*image, states.data(), states.size());
+	appendSection(*image, nullptr, 0);
+	header.fileSize = image->size();
+	std::memcpy(image->data(), &header, sizeof(header));
+	return true;
+}
+
+
+bool AnnotationContainer::exportCSV(const QString& csvPath) const {
+	if (m_header == nullptr) return false;
+	QFile file(csvPath);
+	if (!file.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+	int numColumns = 3*numKeypoints()+1;
+	QByteArray header;
+	for (int row = 0; row < 4; row++) {
+		for (int column = 0; column < numColumns; column++) {
+			if (column > 0) header.append(',');
+			header.append(headerCell(row, column).toUtf8());
+		}
+		header.append('\n');
+	}
+	file.write(header);
+	for (int row = 0; row < numRows(); row++) {
+		file.write(formatRow(frameName(row), x(row), y(row), states(row),
+					numKeypoints()));
+	}
+	file.close();
+	return true;
+}
+
+
+int AnnotationContainer::numRows() const {
+	return m_header != nullptr ? m_header->numRows : 0;
+}
+
+
+int AnnotationContainer::numKeypoints() const {
+	return m_header != nullptr ? m_header->numKeypoints : 0;
+}
+
+
+QString AnnotationContainer::headerCell(int headerRow, int column) const {
+	int numColumns = 3*numKeypoints()+1;
+	if (m_header == nullptr || headerRow < 0 || headerRow >= 4 || column < 0 ||
+				column >= numColumns) {
+		return QString();
+	}
+	return m_names[section<quint32>(m_header->headerCellsOffset)[
+				headerRow*numColumns+column]];
+}
+
+
+QString AnnotationContainer::frameName(int row) const {
+	return m_names[section<quint32>(m_header->frameNamesOffset)[row]];
+}
+
+
+const float *AnnotationContainer::x(int row) const {
+	return section<float>(m_header->xOffset) + static_cast<qint64>(row)*numKeypoints();
+}
+
+
+const float *AnnotationContainer::y(int row) const {
+	return section<float>(m_header->yOffset) + static_cast<qint64>(row)*numKeypoints();
+}
+
+
+const uint8_t *AnnotationContainer::states(int row) const {
+	return section<uint8_t>(m_header->stateOffset) + static_cast<qint64>(row)*numKeypoints();
+}
+
+
+qint64 AnnotationContainer::csvRowOffset(int row) const {
+	return section<qint64>(m_header->rowOffsetsOffset)[row];
+}
+
+
+void AnnotationContainer::storeRow(int row, const float *x, const float *y,
+			const uint8_t *states) {
+	if (m_header == nullptr || !m_writable || row >= numRows()) return;
+	qint64 start = static_cast<qint64>(row)*numKeypoints();
+	std::memcpy(section<float>(m_header->xOffset) + start, x, numKeypoints()*sizeof(float));
+	std::memcpy(section<float>(m_header->yOffset) + start, y, numKeypoints()*sizeof(float));
+	std::memcpy(section<uint8_t>(m_header->stateOffset) + start, states, numKeypoints());
+}
+
+
+void AnnotationContainer::setCsvRowOffsets(const QList<qint64>& offsets) {
+	if (m_header == nullptr || !m_writable || offsets.size() != numRows()+1) return;
+	std::memcpy(section<qint64>(m_header->rowOffsetsOffset), offsets.constData(),
+				offsets.size()*sizeof(qint64));
+}
+
+
+QByteArray AnnotationContainer::formatRow(const QString& frameName, const float *x,
+			const float *y, const uint8_t *states, int numKeypoints) {
+	QByteArray row;
+	QTextStream stream(&row, QIODevice::WriteOnly);
+	stream << frameName << ",";
+	for (int i = 0; i < numKeypoints; i++) {
+		if (std::isnan(x[i])) {
+			stream << ",,";
+		}
+		else {
+			stream << x[i] << "," << y[i] << ",";
+		}
+		stream << static_cast<int>(states[i]) << ",";
+	}
+	stream << "\n";
+	stream.flush();
+	return row;
+}
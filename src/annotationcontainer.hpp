@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * File:			  annotationcontainer.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef ANNOTATIONCONTAINER_H
+#define ANNOTATIONCONTAINER_H
+
+#include "globals.hpp"
+
+#include <QFile>
+
+#include <vector>
+
+
+// Binary companion of a camera's annotations.csv (annotations.bin in the same
+// folder). The file consists of a fixed header, an interned name table holding
+// every header cell and frame name once, and columnar float32 x/y and uint8
+// state arrays laid out as [row][keypoint]. It also remembers the byte offset
+// of every row in the csv so single rows can be patched there as well.
+//
+// The container is only trusted while the size and modification time of the
+// csv match the stamp in its header, otherwise it is rebuilt from the csv.
+// It is only written to disk for csvs of at least a megabyte, smaller ones
+// parse fast enough and are kept in memory. A stale container is replaced by
+// renaming a new one over it, never rewritten in place. Rows are only stored
+// once they have been written to the csv, so the container never holds edits
+// the csv does not. They have to be sync()ed before the stamp is updated,
+// updateCsvStamp() syncs the stamp itself.
+// Empty csv coordinates are stored as NaN, so exporting reproduces the csv
+// layout written by the annotation tool. The csv is tokenized in place from
+// the mapped file, openAll() imports the containers of all cameras in
+// parallel.
+class AnnotationContainer {
+	public:
+		enum OpenMode {ReadOnly, ReadWrite};
+
+		explicit AnnotationContainer(const QString& cameraFolder);
+		~AnnotationContainer();
+
+		bool open(OpenMode mode = ReadOnly);
+		void close();
+		bool isOpen() const {return m_header != nullptr;}
+		bool isMapped() const {return m_mappedData != nullptr;}
+		bool exportCSV(const QString& csvPath) const;
+		void updateCsvStamp();
+		bool sync();
+
+		int numRows() const;
+		int numKeypoints() const;
+		QString headerCell(int headerRow, int column) const;
+		QString scorer() const {return headerCell(0, 1);}
+		QString entity(int keypointId) const {return headerCell(1, 3*keypointId+1);}
+		QString bodypart(int keypointId) const {return headerCell(2, 3*keypointId+1);}
+		QString frameName(int row) const;
+		const float *x(int row) const;
+		const float *y(int row) const;
+		const uint8_t *states(int row) const;
+		qint64 csvRowOffset(int row) const;
+
+		void storeRow(int row, const float *x, const float *y,
+					const uint8_t *states);
+		void setCsvRowOffsets(const QList<qint64>& offsets);
+
+		static QString csvPath(const QString& cameraFolder);
+		static QString containerPath(const QString& cameraFolder);
+		static QByteArray formatRow(const QString& frameName, const float *x,
+					const float *y, const uint8_t *states, int numKeypoints);
+		static bool openAll(const QList<AnnotationContainer*>& containers,
+					OpenMode mode = ReadOnly);
+
+	private:
+		struct Header {
+			char magic[8];
+			quint32 version;
+			quint32 numRows;
+			quint32 numKeypoints;
+			quint32 numNames;
+			qint64 csvSize;
+			qint64 csvModified;
+			quint64 namesOffset;
+			quint64 headerCellsOffset;
+			quint64 frameNamesOffset;
+			quint64 rowOffsetsOffset;
+			quint64 xOffset;
+			quint64 yOffset;
+			quint64 stateOffset;
+			quint64 fileSize;
+			char reserved[24];
+		};
+
+		bool importCSV(QByteArray *image) const;
+		static float parseFloat(const char *begin, const char *end);
+		bool attach(uchar *data, qint64 size);
+		bool stampMatches() const;
+		template <typename T> T *section(quint64 offset) const {
+			return reinterpret_cast<T*>(m_data + offset);
+		}
+
+		QString m_cameraFolder;
+		QFile m_file;
+		std::vector<quint64> m_ownedData;
+		bool m_writable = false;
+		uchar *m_mappedData = nullptr;
+		uchar *m_data = nullptr;
+		Header *m_header = nullptr;
+		QList<QString> m_names;
+};
+
+#endif
@@ -0,0 +1,189 @@
+/*******************************************************************************
+ * File:			  benchmark.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "globals.hpp"
+#include "syntheticdataset.hpp"
+#include "dataset.hpp"
+#include "datasetlist.hpp"
+#include "trainingsetexporter.hpp"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+#include <iomanip>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+
+// Times the dataset code paths that scale with the size of a dataset on a
+// synthetic dataset. Runs headless, the widgets that are involved are created
+// on the offscreen platform.
+
+static double peakRSS() {
+#ifdef Q_OS_UNIX
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) return -1.0;
+#ifdef Q_OS_MACOS
+	return usage.ru_maxrss/(1024.0*1024.0);
+#else
+	return usage.ru_maxrss/1024.0;
+#endif
+#else
+	return -1.0;
+#endif
+}
+
+
+static void report(const QString& stage, qint64 nsecs, double items,
+			const QString& unit) {
+	double seconds = nsecs/1e9;
+	std::cout << std::left << std::setw(16) << stage.toStdString() << std::right
+				<< std::fixed << std::setprecision(3) << std::setw(10) << seconds << " s"
+				<< std::setprecision(0) << std::setw(12)
+				<< (seconds > 0 ? items/seconds : 0.0) << " " << unit.toStdString() << "/s"
+				<< std::setprecision(1) << "   peak RSS " << peakRSS() << " MB"
+				<< std::endl;
+}
+
+
+static QList<Dataset*> loadSegments(const SyntheticDataset& synthetic) {
+	QList<Dataset*> datasets;
+	const QString basePath = synthetic.config().path;
+	for (const auto& segment : synthetic.segmentNames()) {
+		Dataset *dataset = new Dataset(basePath + "/" + segment, basePath,
+					synthetic.cameraNames(), synthetic.skeleton(),
+					synthetic.segmentNames());
+		if (!dataset->loadSuccessfull()) {
+			std::cout << "Could not load " << segment.toStdString() << std::endl;
+			delete dataset;
+			qDeleteAll(datasets);
+			return {};
+		}
+		datasets.append(dataset);
+	}
+	return datasets;
+}
+
+
+int main(int argc, char *argv[]) {
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	}
+	QApplication app(argc, argv);
+	QCoreApplication::setApplicationName("AnnotationToolBenchmark");
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Times loading, saving, counting and "
+				"exporting of a synthetic dataset.");
+	parser.addHelpOption();
+	parser.addOption({"output", "Folder the dataset and the trainingset are "
+				"written to, a temporary folder is used by default.", "path"});
+	SyntheticDataset::addOptions(parser);
+	parser.process(app);
+
+	SyntheticDatasetConfig config;
+	if (!SyntheticDataset::configFromOptions(parser, &config)) {
+		std::cout << "Invalid dataset parameters" << std::endl;
+		return 1;
+	}
+	QTemporaryDir tempDir;
+	QString outputPath = parser.isSet("output") ? parser.value("output") :
+				tempDir.path();
+	config.path = outputPath + "/" + config.name;
+	QDir(config.path).removeRecursively();
+
+	SyntheticDataset synthetic(config);
+	const double numFrames = synthetic.numFrames();
+	const double numFrameSets = numFrames/config.numCameras;
+	std::cout << config.numRecordings*config.numSegments << " segments, "
+				<< config.numCameras << " cameras, " << config.numFrameSets
+				<< " frame sets per segment, " << config.numEntities*config.numKeypoints
+				<< " keypoints" << std::endl;
+	QElapsedTimer timer;
+
+	timer.start();
+	if (!synthetic.generate()) return 1;
+	report("generate", timer.nsecsElapsed(), numFrames, "frames");
+
+	//First load builds the annotation containers and the dataset index
+	timer.start();
+	QList<Dataset*> datasets = loadSegments(synthetic);
+	if (datasets.isEmpty()) return 1;
+	report("load (cold)", timer.nsecsElapsed(), numFrames, "frames");
+	qDeleteAll(datasets);
+
+	timer.start();
+	datasets = loadSegments(synthetic);
+	if (datasets.isEmpty()) return 1;
+	report("load (indexed)", timer.nsecsElapsed(), numFrames, "frames");
+
+	//Touch one keypoint in every frame, so every row of every csv is rewritten
+	timer.start();
+	for (const auto& dataset : datasets) {
+		KeypointStore *store = dataset->keypointStore();
+		for (int imgSet = 0; imgSet < store->numImgSets(); imgSet++) {
+			for (int cam = 0; cam < store->numCameras(); cam++) {
+				int idx = store->index(imgSet, cam, 0);
+				store->setCoordinates(imgSet, cam, 0, store->x(idx)+0.5f,
+							store->y(idx));
+			}
+		}
+	}
+	QCoreApplication::processEvents();
+	for (const auto& dataset : datasets) {
+		dataset->flush();
+	}
+	report("save", timer.nsecsElapsed(), numFrames, "frames");
+	qDeleteAll(datasets);
+	datasets.clear();
+
+	QList<DatasetExportItem> exportItems;
+	QList<QPair<QString,bool>> entities;
+	QList<QPair<QString,bool>> keypoints;
+	QList<SkeletonComponent> skeleton;
+	DatasetList datasetList(exportItems, entities, keypoints, skeleton);
+	timer.start();
+	datasetList.addItem(synthetic.configFilePath());
+	if (exportItems.isEmpty()) {
+		std::cout << "Could not analyse " <<
+					synthetic.configFilePath().toStdString() << std::endl;
+		return 1;
+	}
+	report("count", timer.nsecsElapsed(), numFrames, "frames");
+
+	ExportConfig exportConfig;
+	exportConfig.trainingSetName = "BenchmarkTrainingSet";
+	exportConfig.savePath = outputPath;
+	exportConfig.trainingSetType = "2D";
+	exportConfig.validationFraction = 0.1;
+	exportConfig.shuffleBeforeSplit = false;
+	exportConfig.useRandomShuffleSeed = false;
+	exportConfig.shuffleSeed = 0;
+	exportConfig.entitiesList = entities;
+	exportConfig.keypointsList = keypoints;
+	exportConfig.skeleton = skeleton;
+	QDir(outputPath + "/" + exportConfig.trainingSetName).removeRecursively();
+	TrainingSetExporter exporter(exportItems);
+	bool exportSucceeded = false;
+	QObject::connect(&exporter, &TrainingSetExporter::exportFinished,
+				[&exportSucceeded](bool success) {exportSucceeded = success;});
+	timer.start();
+	exporter.exportTrainingsetSlot(exportConfig);
+	if (!exportSucceeded) {
+		std::cout << "Trainingset export failed" << std::endl;
+		return 1;
+	}
+	report("export", timer.nsecsElapsed(), numFrameSets, "frame sets");
+	return 0;
+}
@@ -0,0 +1,49 @@
+/*******************************************************************************
+ * File:			  generatedataset.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "globals.hpp"
+#include "syntheticdataset.hpp"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+
+
+int main(int argc, char *argv[]) {
+	QCoreApplication app(argc, argv);
+	QCoreApplication::setApplicationName("GenerateDataset");
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Generates a synthetic JARVIS dataset.");
+	parser.addHelpOption();
+	parser.addPositionalArgument("path", "Folder the dataset is written to.");
+	parser.addOption({"name", "Name of the dataset.", "name", "SyntheticDataset"});
+	SyntheticDataset::addOptions(parser);
+	parser.process(app);
+
+	if (parser.positionalArguments().size() != 1) {
+		parser.showHelp(1);
+	}
+	SyntheticDatasetConfig config;
+	if (!SyntheticDataset::configFromOptions(parser, &config)) {
+		std::cout << "Invalid dataset parameters" << std::endl;
+		return 1;
+	}
+	config.path = parser.positionalArguments()[0];
+	config.name = parser.value("name");
+
+	SyntheticDataset dataset(config);
+	QElapsedTimer timer;
+	timer.start();
+	if (!dataset.generate()) return 1;
+	std::cout << "Generated " << dataset.numFrames() << " frames ("
+				<< dataset.bytesWritten()/1024 << " kB) in " << timer.elapsed()
+				<< " ms: " << dataset.configFilePath().toStdString() << std::endl;
+	return 0;
+}
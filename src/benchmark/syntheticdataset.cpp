@@ -0,0 +1,274 @@
+/*******************************************************************************
+ * File:			  syntheticdataset.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "syntheticdataset.hpp"
+#include "annotationcontainer.hpp"
+
+#include "yaml-cpp/yaml.h"
+
+#include <QBuffer>
+#include <QDate>
+#include <QDir>
+#include <QFile>
+#include <QImage>
+
+#include <cmath>
+#include <fstream>
+#include <random>
+
+
+SyntheticDataset::SyntheticDataset(const SyntheticDatasetConfig& config) :
+			m_config(config) {}
+
+
+QString SyntheticDataset::configFilePath() const {
+	return m_config.path + "/" + m_config.name + ".yaml";
+}
+
+
+QList<QString> SyntheticDataset::segmentNames() const {
+	QList<QString> segmentNames;
+	for (int recording = 0; recording < m_config.numRecordings; recording++) {
+		for (int segment = 0; segment < m_config.numSegments; segment++) {
+			segmentNames.append("Recording_" + QString::number(recording) +
+						"/Segment_" + QString::number(segment));
+		}
+	}
+	return segmentNames;
+}
+
+
+QList<QString> SyntheticDataset::cameraNames() const {
+	QList<QString> cameraNames;
+	for (int cam = 0; cam < m_config.numCameras; cam++) {
+		cameraNames.append("Camera_" + QString::number(cam));
+	}
+	return cameraNames;
+}
+
+
+QList<QString> SyntheticDataset::entityNames() const {
+	QList<QString> entityNames;
+	for (int entity = 0; entity < m_config.numEntities; entity++) {
+		entityNames.append("Entity_" + QString::number(entity));
+	}
+	return entityNames;
+}
+
+
+QList<QString> SyntheticDataset::keypointNames() const {
+	QList<QString> keypointNames;
+	for (int keypoint = 0; keypoint < m_config.numKeypoints; keypoint++) {
+		keypointNames.append("Keypoint_" + QString::number(keypoint));
+	}
+	return keypointNames;
+}
+
+
+QList<SkeletonComponent> SyntheticDataset::skeleton() const {
+	//Simple chain through all keypoints
+	QList<SkeletonComponent> skeleton;
+	QList<QString> keypoints = keypointNames();
+	for (int i = 0; i+1 < keypoints.size(); i++) {
+		SkeletonComponent bone;
+		bone.name = "Bone_" + QString::number(i);
+		bone.keypointA = keypoints[i];
+		bone.keypointB = keypoints[i+1];
+		bone.length = 10.0;
+		skeleton.append(bone);
+	}
+	return skeleton;
+}
+
+
+int SyntheticDataset::numFrames() const {
+	return m_config.numRecordings*m_config.numSegments*m_config.numFrameSets*
+				m_config.numCameras;
+}
+
+
+void SyntheticDataset::addOptions(QCommandLineParser& parser) {
+	SyntheticDatasetConfig defaults;
+	parser.addOptions({
+		{"recordings", "Number of recordings.", "n", QString::number(defaults.numRecordings)},
+		{"segments", "Number of segments per recording.", "n", QString::number(defaults.numSegments)},
+		{"cameras", "Number of cameras.", "n", QString::number(defaults.numCameras)},
+		{"framesets", "Number of frame sets per segment.", "n", QString::number(defaults.numFrameSets)},
+		{"entities", "Number of entities.", "n", QString::number(defaults.numEntities)},
+		{"keypoints", "Number of keypoints per entity.", "n", QString::number(defaults.numKeypoints)},
+		{"annotated", "Fraction of annotated keypoints.", "fraction", QString::number(defaults.annotatedFraction)},
+		{"seed", "Seed for the random keypoint positions.", "seed", QString::number(defaults.seed)}
+	});
+}
+
+
+bool SyntheticDataset::configFromOptions(const QCommandLineParser& parser,
+			SyntheticDatasetConfig *config) {
+	bool ok[8];
+	config->numRecordings = parser.value("recordings").toInt(&ok[0]);
+	config->numSegments = parser.value("segments").toInt(&ok[1]);
+	config->numCameras = parser.value("cameras").toInt(&ok[2]);
+	config->numFrameSets = parser.value("framesets").toInt(&ok[3]);
+	config->numEntities = parser.value("entities").toInt(&ok[4]);
+	config->numKeypoints = parser.value("keypoints").toInt(&ok[5]);
+	config->annotatedFraction = parser.value("annotated").toDouble(&ok[6]);
+	config->seed = parser.value("seed").toUInt(&ok[7]);
+	for (int i = 0; i < 8; i++) {
+		if (!ok[i]) return false;
+	}
+	return config->numRecordings > 0 && config->numSegments > 0 &&
+				config->numCameras > 0 && config->numFrameSets > 0 &&
+				config->numEntities > 0 && config->numKeypoints > 0 &&
+				config->annotatedFraction >= 0.0 && config->annotatedFraction <= 1.0;
+}
+
+
+bool SyntheticDataset::generate() {
+	m_bytesWritten = 0;
+	QImage image(m_config.imageSize, QImage::Format_RGB888);
+	image.fill(QColor(128,128,128));
+	QByteArray encodedImage;
+	QBuffer buffer(&encodedImage);
+	buffer.open(QIODevice::WriteOnly);
+	if (!image.save(&buffer, "JPG")) {
+		std::cout << "Could not encode placeholder jpeg, is the Qt jpeg plugin "
+					"available?" << std::endl;
+		return false;
+	}
+	if (!QDir().mkpath(m_config.path) || !writeConfigFile()) {
+		std::cout << "Could not create dataset in " <<
+					m_config.path.toStdString() << std::endl;
+		return false;
+	}
+	quint32 seed = m_config.seed;
+	for (const auto& segmentName : segmentNames()) {
+		if (!writeSegment(m_config.path + "/" + segmentName, encodedImage, seed++)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+bool SyntheticDataset::writeConfigFile() {
+	YAML::Node config;
+	config["Name"] = m_config.name.toStdString();
+	config["Date of creation"] =
+				QDate::currentDate().toString(Qt::ISODate).toStdString();
+	for (int recording = 0; recording < m_config.numRecordings; recording++) {
+		std::string recordingName = "Recording_" + std::to_string(recording);
+		config["Recordings"][recordingName] = YAML::Node();
+		for (int segment = 0; segment < m_config.numSegments; segment++) {
+			config["Recordings"][recordingName].push_back("Segment_" +
+						std::to_string(segment));
+		}
+	}
+	for (const auto& camera : cameraNames()) {
+		config["Cameras"].push_back(camera.toStdString());
+	}
+	for (const auto& entity : entityNames()) {
+		config["Entities"].push_back(entity.toStdString());
+	}
+	for (const auto& keypoint : keypointNames()) {
+		config["Keypoints"].push_back(keypoint.toStdString());
+	}
+	for (const auto& bone : skeleton()) {
+		config["Skeleton"][bone.name.toStdString()]["Keypoints"].push_back(
+					bone.keypointA.toStdString());
+		config["Skeleton"][bone.name.toStdString()]["Keypoints"].push_back(
+					bone.keypointB.toStdString());
+		config["Skeleton"][bone.name.toStdString()]["Length"].push_back(
+					bone.length);
+	}
+	std::ofstream configStream(configFilePath().toStdString());
+	configStream << config;
+	return configStream.good();
+}
+
+
+bool SyntheticDataset::writeSegment(const QString& segmentFolder,
+			const QByteArray& image, quint32 seed) {
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> xDist(0.0f, m_config.imageSize.width()-1);
+	std::uniform_real_distribution<float> yDist(0.0f, m_config.imageSize.height()-1);
+	std::bernoulli_distribution annotated(m_config.annotatedFraction);
+	const int numKeypoints = m_config.numEntities*m_config.numKeypoints;
+	std::vector<float> x(numKeypoints);
+	std::vector<float> y(numKeypoints);
+	std::vector<uint8_t> states(numKeypoints);
+	const QByteArray header = csvHeader();
+
+	for (const auto& camera : cameraNames()) {
+		QString cameraFolder = segmentFolder + "/" + camera;
+		if (!QDir().mkpath(cameraFolder)) {
+			std::cout << "Could not create " << cameraFolder.toStdString() << std::endl;
+			return false;
+		}
+		QByteArray csv = header;
+		for (int frameSet = 0; frameSet < m_config.numFrameSets; frameSet++) {
+			QString frameName = "Frame_" + QString::number(frameSet) + ".jpg";
+			if (!writeFile(cameraFolder + "/" + frameName, image)) return false;
+			for (int i = 0; i < numKeypoints; i++) {
+				if (annotated(rng)) {
+					x[i] = std::round(xDist(rng)*100.0f)/100.0f;
+					y[i] = std::round(yDist(rng)*100.0f)/100.0f;
+					states[i] = Annotated;
+				}
+				else {
+					x[i] = std::nanf("");
+					y[i] = std::nanf("");
+					states[i] = NotAnnotated;
+				}
+			}
+			csv.append(AnnotationContainer::formatRow(frameName, x.data(), y.data(),
+						states.data(), numKeypoints));
+		}
+		if (!writeFile(AnnotationContainer::csvPath(cameraFolder), csv)) return false;
+	}
+	return true;
+}
+
+
+QByteArray SyntheticDataset::csvHeader() const {
+	//Same layout as Dataset::csvHeader()
+	QList<QString> entities = entityNames();
+	QList<QString> keypoints = keypointNames();
+	const int numColumns = entities.size()*keypoints.size()*3;
+	QByteArray header = "Scorer";
+	for (int i = 0; i < numColumns; i++) {
+		header += ",Synthetic";
+	}
+	header += "\nentities";
+	for (int i = 0; i < numColumns; i++) {
+		header += "," + entities[i/(keypoints.size()*3)].toUtf8();
+	}
+	header += "\nbodyparts";
+	for (int i = 0; i < numColumns; i++) {
+		header += "," + keypoints[(i/3)%keypoints.size()].toUtf8();
+	}
+	header += "\ncoords";
+	for (int i = 0; i < numColumns; i++) {
+		if (i%3 == 0) header += ",x";
+		else if (i%3 == 2) header += ",state";
+		else header += ",y";
+	}
+	header += "\n";
+	return header;
+}
+
+
+bool SyntheticDataset::writeFile(const QString& path, const QByteArray& data) {
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+		std::cout << "Could not write " << path.toStdString() << std::endl;
+		return false;
+	}
+	m_bytesWritten += data.size();
+	return true;
+}
@@ -0,0 +1,69 @@
+/*******************************************************************************
+ * File:			  syntheticdataset.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef SYNTHETICDATASET_H
+#define SYNTHETICDATASET_H
+
+#include "globals.hpp"
+
+#include <QCommandLineParser>
+#include <QSize>
+
+
+struct SyntheticDatasetConfig {
+	QString path;
+	QString name = "SyntheticDataset";
+	int numRecordings = 1;
+	int numSegments = 2;
+	int numCameras = 8;
+	int numFrameSets = 200;
+	int numEntities = 1;
+	int numKeypoints = 20;
+	double annotatedFraction = 0.6;
+	QSize imageSize = QSize(64, 48);
+	quint32 seed = 42;
+};
+
+
+// Writes a dataset in the layout created by the DatasetCreator:
+// <path>/<name>.yaml and <path>/<recording>/<segment>/<camera>/ holding the
+// annotations.csv and one tiny placeholder jpeg per frame. Every frame uses the
+// same encoded image, so generating large datasets is bound by the file system
+// and not by the encoder.
+class SyntheticDataset {
+	public:
+		explicit SyntheticDataset(const SyntheticDatasetConfig& config);
+
+		bool generate();
+		const SyntheticDatasetConfig& config() const {return m_config;}
+		QString configFilePath() const;
+		QList<QString> segmentNames() const;
+		QList<QString> cameraNames() const;
+		QList<QString> entityNames() const;
+		QList<QString> keypointNames() const;
+		QList<SkeletonComponent> skeleton() const;
+		int numFrames() const;
+		qint64 bytesWritten() const {return m_bytesWritten;}
+
+		static void addOptions(QCommandLineParser& parser);
+		static bool configFromOptions(const QCommandLineParser& parser,
+					SyntheticDatasetConfig *config);
+
+	private:
+		bool writeConfigFile();
+		bool writeSegment(const QString& segmentFolder, const QByteArray& image,
+					quint32 seed);
+		QByteArray csvHeader() const;
+		bool writeFile(const QString& path, const QByteArray& data);
+
+		SyntheticDatasetConfig m_config;
+		qint64 m_bytesWritten = 0;
+};
+
+#endif
@@ -8,12 +8,20 @@
  ******************************************************************************/
 
 #include "dataset.hpp"
+#include "profiler.hpp"
 
 #include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QCoreApplication>
 #include <QDir>
 #include <QTextStream>
 #include <QErrorMessage>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 
 Dataset * Dataset::dataset = nullptr;
 
@@ -21,6 +29,7 @@ Dataset::Dataset(const QString& datasetFolder, const QString& datasetBaseFolder,
 			QList<QString> cameraNames, QList<SkeletonComponent> skeleton,
 			QList<QString> segmentNames, bool annotateSetup, QList<QString> setupKeypoints) :
 			m_datasetFolder(datasetFolder), m_datasetBaseFolder(datasetBaseFolder),
+			m_index(datasetBaseFolder, datasetFolder),
 			m_skeleton(skeleton), m_segmentNames(segmentNames), m_annotateSetup(annotateSetup), m_setupKeypointsList(setupKeypoints) {
 	m_colorMap = new ColorMap(ColorMap::Jet);
 	if (cameraNames.size() == 0) {
@@ -34,18 +43,22 @@ Dataset::Dataset(const QString& datasetFolder, const QString& datasetBaseFolder,
 	if (m_numCameras == 0) {
 		return;
 	}
-	QList<QFile*> saveFiles;
+	//A compaction that was interrupted after its commit marker is finished
+	//before any csv is read
+	if (!m_annotateSetup) {
+		DatasetWriter::recoverCommit(datasetFolder, m_cameraNames);
+	}
 	for (int i = 0; i < m_numCameras; i++) {
-		QFile *file = new QFile(datasetFolder + "/" + m_cameraNames[i] +
-														"/annotations.csv");
-		saveFiles.append(file);
-		if (!file->open(QIODevice::ReadOnly)) {
-			return;
-		}
+		m_containers.append(new AnnotationContainer(datasetFolder + "/" +
+					m_cameraNames[i]));
 	}
-	int lineCount = 0;
-	m_scorer = saveFiles[0]->readLine().split(',')[1];
-	QList<QByteArray> cells = saveFiles[0]->readLine().split(',');
+	if (!AnnotationContainer::openAll(m_containers, m_annotateSetup ?
+				AnnotationContainer::ReadOnly : AnnotationContainer::ReadWrite)) {
+		return;
+	}
+	m_index.load();
+	AnnotationContainer *primaryContainer = m_containers[0];
+	m_scorer = primaryContainer->scorer();
 	if (m_annotateSetup) {
 		m_entitiesList.append("Setup");
 		for (const auto & keypoint : m_setupKeypointsList) {
@@ -53,152 +66,305 @@ Dataset::Dataset(const QString& datasetFolder, const QString& datasetBaseFolder,
 		m_keypointNameList.append(keypoint);
 		m_bodypartsList.append(keypoint);
 		}
-		cells = saveFiles[0]->readLine().split(',');
 	}
 	else {
-		for (int i = 1; i < cells.size(); i+= 3) {
-			m_entityNameList.append(cells[i]);
-			if(!m_entitiesList.contains(cells[i])) m_entitiesList.append(cells[i]);
-		}
-		cells = saveFiles[0]->readLine().split(',');
-		for (int i = 1; i < cells.size(); i+= 3) {
-			m_keypointNameList.append(cells[i]);
-			if (!m_bodypartsList.contains(cells[i])) m_bodypartsList.append(cells[i]);
+		for (int i = 0; i < primaryContainer->numKeypoints(); i++) {
+			QString entity = primaryContainer->entity(i);
+			QString bodypart = primaryContainer->bodypart(i);
+			m_entityNameList.append(entity);
+			if(!m_entitiesList.contains(entity)) m_entitiesList.append(entity);
+			m_keypointNameList.append(bodypart);
+			if (!m_bodypartsList.contains(bodypart)) m_bodypartsList.append(bodypart);
 		}
 	}
-	saveFiles[0]->readLine();
-	for (int i = 1; i < m_numCameras; i++) {
-		saveFiles[i]->readLine();
-		saveFiles[i]->readLine();
-		saveFiles[i]->readLine();
-		saveFiles[i]->readLine();
+	const int numKeypoints = m_keypointNameList.size();
+	m_keypointStore = new KeypointStore(m_numCameras, numKeypoints, this);
+	for (int i = 0; i < numKeypoints; i++) {
+		QColor color = m_colorMap->getColor(i%m_bodypartsList.size(),
+					m_bodypartsList.size());
+		m_keypointStore->setKeypointInfo(i, m_entityNameList[i],
+					m_keypointNameList[i], color);
+	}
+	for (const auto& bone : m_skeleton) {
+		m_skeletonBodyparts.append(QPair<int,int>(
+					m_keypointStore->bodypartIndex(bone.keypointA),
+					m_keypointStore->bodypartIndex(bone.keypointB)));
+	}
+
+	const int numRows = primaryContainer->numRows();
+	QList<QList<qint64>> rowOffsets;
+	for (int cam = 0; cam < m_numCameras; cam++) {
+		m_dirtyImgSets.append(QSet<int>());
+		rowOffsets.append(QList<qint64>());
+		if (m_containers[cam]->numRows() == numRows) {
+			for (int row = 0; row <= numRows; row++) {
+				rowOffsets[cam].append(m_containers[cam]->csvRowOffset(row));
+			}
+		}
+		QList<DatasetIndex::KeypointCount> counts;
+		int frameCount;
+		if (!m_index.keypointCounts(m_cameraNames[cam], &counts, &frameCount)) {
+			m_index.setKeypointCounts(m_cameraNames[cam],
+						DatasetIndex::countKeypoints(*m_containers[cam]),
+						m_containers[cam]->numRows());
+		}
 	}
-	while (!saveFiles[0]->atEnd()) {
+	for (int row = 0; row < numRows; row++) {
 		ImgSet *imgSet = new ImgSet();
 		imgSet->numCameras = m_numCameras;
+		int imgSetIndex = m_keypointStore->addImgSet();
 		for (int cam = 0; cam < m_numCameras; cam++) {
-			cells = saveFiles[cam]->readLine().split(',');
+			AnnotationContainer *container = m_containers[cam];
+			bool hasRow = row < container->numRows();
+			QString frameName = hasRow ? container->frameName(row) : QString();
 			Frame *frame = new Frame();
 			frame->imagePath = datasetFolder + "/" + m_cameraNames[cam] + "/" +
-												 cells[0];
-			int x,y;
-			GetImageSizeEx(frame->imagePath, &x,&y);
-			frame->imageDimensions = QSize(x,y);
-			frame->numKeypoints = m_keypointNameList.size();
-			for (int i = 0; i < m_keypointNameList.size(); i++) {
-				QColor color = m_colorMap->getColor(i%m_bodypartsList.size(),
-							m_bodypartsList.size());
-
-				Keypoint *keypoint = new Keypoint(m_entityNameList[i],
-							m_keypointNameList[i],
-							color,
-							QPointF(cells[3*i+1].toFloat(),
-							cells[3*i+2].toFloat()));
-				keypoint->setFrameIndex(cam);
-				if (!m_annotateSetup) {
-					if (cells[3*i+3].toInt() == 0) {
-						keypoint->setState(NotAnnotated);
-					}
-					else if (cells[3*i+3].toInt() == 1) {
-						keypoint->setState(Annotated);
-					}
-					else if (cells[3*i+3].toInt() == 2) {
-						//keypoint->setState(Reprojected);
-						keypoint->setState(NotAnnotated);
-					}
-					else if (cells[3*i+3].toInt() == 3) {
-						keypoint->setState(Suppressed);
-					}
+												 frameName;
+			QFileInfo imageInfo(frame->imagePath);
+			if (!m_index.imageDimensions(m_cameraNames[cam], frameName, imageInfo,
+						&frame->imageDimensions)) {
+				int x = 0, y = 0;
+				if (GetImageSizeEx(frame->imagePath, &x,&y)) {
+					m_index.setImageDimensions(m_cameraNames[cam], frameName, imageInfo,
+								QSize(x,y));
 				}
-				connect(keypoint, &Keypoint::stateChanged,
-								this, &Dataset::keypointStateChanged);
-
-				frame->keypoints.append(keypoint);
-				frame->keypointMap[keypoint->ID()] = keypoint;
+				frame->imageDimensions = QSize(x,y);
 			}
+			frame->numKeypoints = numKeypoints;
+			frame->imgSetIndex = imgSetIndex;
+			frame->frameIndex = cam;
+			frame->keypointStore = m_keypointStore;
 			imgSet->frames.append(frame);
+			if (!hasRow || m_annotateSetup) continue;
+
+			const float *xs = container->x(row);
+			const float *ys = container->y(row);
+			const uint8_t *states = container->states(row);
+			int containerKeypoints = std::min(numKeypoints, container->numKeypoints());
+			for (int i = 0; i < containerKeypoints; i++) {
+				KeypointState state = NotAnnotated;
+				if (states[i] == Annotated) {
+					state = Annotated;
+				}
+				else if (states[i] == Suppressed) {
+					state = Suppressed;
+				}
+				else if (states[i] == Reprojected) {
+					//Reprojected keypoints are loaded as not annotated until they are
+					//recalculated, the row is rewritten so the csv matches again
+					m_dirtyImgSets[cam].insert(imgSetIndex);
+				}
+				m_keypointStore->initKeypoint(imgSetIndex, cam, i,
+							std::isnan(xs[i]) ? 0.0f : xs[i],
+							std::isnan(ys[i]) ? 0.0f : ys[i], state);
+			}
 		}
-		lineCount += 1;
 		m_imgSets.append(imgSet);
-  }
-	for (int i = 0; i < m_numCameras; i++) {
-		saveFiles[i]->close();
+	}
+
+	//Edits that were journaled but never made it into the csvs
+	EditJournal journal(datasetFolder);
+	if (!m_annotateSetup && journal.open(m_imgSets.size(), m_numCameras,
+				numKeypoints)) {
+		int numRecovered = journal.replay([this](const EditJournal::Record& record) {
+			m_keypointStore->initKeypoint(record.imgSetIndex, record.frameIndex,
+						record.keypointId, record.x, record.y, record.state);
+			m_dirtyImgSets[record.frameIndex].insert(record.imgSetIndex);
+		});
+		if (numRecovered > 0) {
+			std::cout << "Recovered " << numRecovered << " unsaved edits from "
+						<< EditJournal::journalPath(datasetFolder).toStdString() << std::endl;
+		}
+		journal.close();
+	}
+	connect(m_keypointStore, &KeypointStore::stateChanged,
+					this, &Dataset::keypointStateChanged);
+	connect(m_keypointStore, &KeypointStore::keypointEdited,
+					this, &Dataset::keypointEditedSlot);
+	if (m_index.isModified()) m_index.save();
+
+	//From here on the writer thread owns the files of this segment
+	if (!m_annotateSetup) {
+		qRegisterMetaType<AnnotationSnapshotPtr>();
+		qRegisterMetaType<EditJournal::Record>();
+		QList<QList<QString>> frameNames;
+		for (int cam = 0; cam < m_numCameras; cam++) {
+			frameNames.append(QList<QString>());
+			for (const auto& imgSet : m_imgSets) {
+				frameNames[cam].append(imgSet->frames[cam]->imagePath.split("/").last());
+			}
+		}
+		m_writer = new DatasetWriter(m_datasetFolder, m_cameraNames, csvHeader(),
+					frameNames, numKeypoints, rowOffsets, m_containers, &m_index);
+		m_writerThread = new QThread(this);
+		m_writer->moveToThread(m_writerThread);
+		connect(this, &Dataset::snapshotReady,
+						m_writer, &DatasetWriter::storeSnapshotSlot);
+		connect(this, &Dataset::journalRecordReady,
+						m_writer, &DatasetWriter::appendJournalSlot);
+		connect(m_writer, &DatasetWriter::writeFailed,
+						this, &Dataset::writeFailedSlot);
+		connect(qApp, &QCoreApplication::aboutToQuit, this, &Dataset::flush);
+		m_writerThread->start();
 	}
 	m_loadSuccessfull = true;
 }
 
 
-void Dataset::save(const QString& datasetFolder) {
-	if (m_annotateSetup) return;
-	QString dataFolder = datasetFolder;
-	if (datasetFolder == "") dataFolder = m_datasetFolder;
-	QList<QFile*> saveFiles;
+Dataset::~Dataset() {
+	if (m_writerThread != nullptr) {
+		flush();
+		m_writerThread->quit();
+		m_writerThread->wait();
+		delete m_writer;
+	}
+	qDeleteAll(m_containers);
+	for (auto& imgSet : m_imgSets) {
+		qDeleteAll(imgSet->frames);
+		delete imgSet;
+	}
+	delete m_colorMap;
+}
 
-	for (int i = 0; i < m_numCameras; i++) {
-		QFile *file = new QFile(dataFolder + "/" + m_cameraNames[i] +
-														"/annotations.csv");
-		saveFiles.append(file);
-		if (!file->open(QIODevice::WriteOnly)) {
-			std::cout << "Can't open File" << std::endl;
-			QErrorMessage *msg = new QErrorMessage();
-			msg->showMessage("Error writing savefile."
-											 "Make sure you have the right permissions...");
+
+void Dataset::save(const QString& datasetFolder) {
+	PROFILE_SCOPE("Dataset save");
+	if (m_annotateSetup || m_writer == nullptr) return;
+	if (datasetFolder != "" && datasetFolder != m_datasetFolder) {
+		//Copies to other folders are written in full and waited for
+		AnnotationSnapshotPtr snapshot = takeSnapshot(true);
+		bool success = false;
+		QMetaObject::invokeMethod(m_writer, [&] {
+					return m_writer->exportSnapshotSlot(datasetFolder, snapshot);},
+					Qt::BlockingQueuedConnection, &success);
+		if (success) {
+			DatasetIndex::invalidate(m_datasetBaseFolder, datasetFolder);
+		}
+		else {
+			showSaveError();
+		}
+		return;
+	}
+	for (const auto& dirtyImgSets : m_dirtyImgSets) {
+		if (!dirtyImgSets.isEmpty()) {
+			emit snapshotReady(takeSnapshot(false));
 			return;
 		}
-		 QTextStream stream(file);
-		 stream << "Scorer";
-		 for (int i = 0; i < m_keypointNameList.size()*3; i++) {
-			 stream << "," << m_scorer;
-		 }
-		 stream << "\n";
-		 stream << "entities";
-		 for (int i = 0; i < m_keypointNameList.size()*3; i++) {
-			 stream << "," << m_entityNameList[i/3];
-		 }
-		 stream << "\n";
-		 stream << "bodyparts";
-		 for (int i = 0; i < m_keypointNameList.size()*3; i++) {
-			 stream << "," << m_keypointNameList[i/3];
-		 }
-		 stream << "\n";
-		 stream << "coords";
-		 for (int i = 0; i < m_keypointNameList.size()*3; i++) {
-			 if (i%3 == 0) stream << "," << "x";
-			 else if (i%3 == 2) stream << "," << "state";
-			 else stream << "," << "y";
-		 }
-		 stream << "\n";
 	}
+}
 
-	for (auto& imgSet : m_imgSets) {
-		for (int cam = 0; cam < m_numCameras; cam++) {
-			QTextStream stream(saveFiles[cam]);
-			stream << imgSet->frames[cam]->imagePath.split("/").last() << ",";
-			for (int i = 0; i < m_keypointNameList.size(); i++) {
-				Keypoint *keypoint = imgSet->frames[cam]->keypointMap[
-														 m_entityNameList[i] + "/" + m_keypointNameList[i]];
-
-				if (keypoint->state() == NotAnnotated) {
-					stream << ",," << 0 << ",";
-				}
-				else if (keypoint->state() == Annotated) {
-					stream << keypoint->rx() << "," << keypoint->ry() << ",";
-					stream << 1 << ",";
-				}
-				else if (keypoint->state() == Reprojected) {
-					stream << keypoint->rx() << "," << keypoint->ry() << ",";
-					stream << 2 << ",";
+
+void Dataset::flush() {
+	if (m_writer == nullptr) return;
+	save();
+	QMetaObject::invokeMethod(m_writer, [this] {m_writer->compactSlot();},
+				Qt::BlockingQueuedConnection);
+}
+
+
+AnnotationSnapshotPtr Dataset::takeSnapshot(bool allRows) {
+	QSharedPointer<AnnotationSnapshot> snapshot =
+				QSharedPointer<AnnotationSnapshot>::create();
+	const int numKeypoints = m_keypointNameList.size();
+	for (int cam = 0; cam < m_numCameras; cam++) {
+		if (!allRows && m_dirtyImgSets[cam].isEmpty()) continue;
+		AnnotationSnapshot::Camera camera;
+		camera.cameraIndex = cam;
+		if (allRows) {
+			for (int i = 0; i < m_imgSets.size(); i++) camera.rows.append(i);
+		}
+		else {
+			camera.rows = m_dirtyImgSets[cam].values();
+			std::sort(camera.rows.begin(), camera.rows.end());
+			m_dirtyImgSets[cam].clear();
+		}
+		size_t size = static_cast<size_t>(camera.rows.size())*numKeypoints;
+		camera.x.resize(size);
+		camera.y.resize(size);
+		camera.states.resize(size);
+		size_t pos = 0;
+		for (const auto& row : camera.rows) {
+			for (int i = 0; i < numKeypoints; i++, pos++) {
+				int idx = m_keypointStore->index(row, cam, i);
+				KeypointState state = m_keypointStore->state(idx);
+				camera.states[pos] = state;
+				if (state == Annotated || state == Reprojected) {
+					camera.x[pos] = m_keypointStore->x(idx);
+					camera.y[pos] = m_keypointStore->y(idx);
 				}
 				else {
-					stream << ",," << 3 << ",";
+					camera.x[pos] = std::numeric_limits<float>::quiet_NaN();
+					camera.y[pos] = std::numeric_limits<float>::quiet_NaN();
 				}
 			}
-			stream << "\n";
 		}
+		snapshot->cameras.append(camera);
 	}
+	return snapshot;
+}
 
-	for (int i = 0; i < m_numCameras; i++) {
-		saveFiles[i]->close();
+
+QByteArray Dataset::csvHeader() const {
+	QByteArray header;
+	QTextStream stream(&header, QIODevice::WriteOnly);
+	stream << "Scorer";
+	for (int i = 0; i < m_keypointNameList.size()*3; i++) {
+		stream << "," << m_scorer;
+	}
+	stream << "\n";
+	stream << "entities";
+	for (int i = 0; i < m_keypointNameList.size()*3; i++) {
+		stream << "," << m_entityNameList[i/3];
+	}
+	stream << "\n";
+	stream << "bodyparts";
+	for (int i = 0; i < m_keypointNameList.size()*3; i++) {
+		stream << "," << m_keypointNameList[i/3];
+	}
+	stream << "\n";
+	stream << "coords";
+	for (int i = 0; i < m_keypointNameList.size()*3; i++) {
+		if (i%3 == 0) stream << "," << "x";
+		else if (i%3 == 2) stream << "," << "state";
+		else stream << "," << "y";
+	}
+	stream << "\n";
+	stream.flush();
+	return header;
+}
+
+
+void Dataset::showSaveError() {
+	std::cout << "Can't open File" << std::endl;
+	QErrorMessage *msg = new QErrorMessage();
+	msg->showMessage("Error writing savefile."
+									 "Make sure you have the right permissions...");
+}
+
+
+void Dataset::writeFailedSlot() {
+	showSaveError();
+}
+
+
+void Dataset::keypointEditedSlot(int imgSetIndex, int frameIndex,
+			int keypointId, KeypointState previousState) {
+	int idx = m_keypointStore->index(imgSetIndex, frameIndex, keypointId);
+	KeypointState state = m_keypointStore->state(idx);
+	//Every change is saved, reprojections are written to the csv like
+	//annotations are
+	if (frameIndex < m_dirtyImgSets.size()) {
+		m_dirtyImgSets[frameIndex].insert(imgSetIndex);
+	}
+	//Reprojections are recalculated on every load, so only changes involving
+	//annotated or suppressed keypoints have to be journaled
+	if ((state == NotAnnotated || state == Reprojected) &&
+				(previousState == NotAnnotated || previousState == Reprojected)) {
+		return;
+	}
+	if (m_writer != nullptr) {
+		emit journalRecordReady({imgSetIndex, frameIndex, keypointId,
+					m_keypointStore->x(idx), m_keypointStore->y(idx), state});
 	}
 }
 
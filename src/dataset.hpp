@@ -13,6 +13,13 @@
 #include "globals.hpp"
 #include "colormap.hpp"
 #include "keypoint.hpp"
+#include "annotationcontainer.hpp"
+#include "datasetindex.hpp"
+#include "editjournal.hpp"
+#include "datasetwriter.hpp"
+
+#include <QSet>
+#include <QThread>
 
 
 class Dataset : public QObject {
@@ -23,6 +30,7 @@ class Dataset : public QObject {
 						 const QString &datasetBaseFolder, QList<QString> cameraNames = {},
 						 QList<SkeletonComponent> skeleton = {},
 						 QList<QString> segmentNames = {}, bool annotateSetup = false, QList<QString> setupKeypoints = {});
+		~Dataset();
 		static Dataset *dataset;
 		QList<ImgSet*> imgSets() {return m_imgSets;}
 		const QString& datasetFolder() {return m_datasetFolder;}
@@ -30,27 +38,42 @@ class Dataset : public QObject {
 		const QString& cameraName(int i) {return m_cameraNames[i];}
 		QList <QString> cameraNames() {return m_cameraNames;}
 		QList <SkeletonComponent> skeleton() {return m_skeleton;}
+		const QList<QPair<int,int>>& skeletonBodyparts() const {return m_skeletonBodyparts;}
 		QList <QString> segmentNames() {return m_segmentNames;}
 		void save(const QString& datasetFolder = "");
+		void flush();
 		int numCameras() const {return m_numCameras;}
 		QList<QString> entitiesList() const {return m_entitiesList;}
 		QList<QString> bodypartsList() const {return m_bodypartsList;}
 		bool loadSuccessfull() const {return m_loadSuccessfull;}
+		KeypointStore *keypointStore() const {return m_keypointStore;}
 
 	signals:
 		void keypointStateChanged(KeypointState state, KeypointState previousState,
-					int frameIndex);
+					int imgSetIndex, int frameIndex);
+		void snapshotReady(AnnotationSnapshotPtr snapshot);
+		void journalRecordReady(EditJournal::Record record);
+
+	private slots:
+		void keypointEditedSlot(int imgSetIndex, int frameIndex, int keypointId,
+					KeypointState previousState);
+		void writeFailedSlot();
 
 	private:
 		bool GetImageSizeEx(QString fn, int *x,int *y);
+		AnnotationSnapshotPtr takeSnapshot(bool allRows);
+		QByteArray csvHeader() const;
+		void showSaveError();
 
 		const QString m_datasetFolder;
 		const QString m_datasetBaseFolder;
+		DatasetIndex m_index;
 		bool m_loadSuccessfull = false;
 		int m_numCameras;
 		int m_numEntities;
 		QList <QString> m_cameraNames;
 		QList <SkeletonComponent> m_skeleton;
+		QList<QPair<int,int>> m_skeletonBodyparts;
 		QList<QString> m_setupKeypointsList;
 		bool m_annotateSetup;
 		QList <QString> m_segmentNames;
@@ -61,6 +84,11 @@ class Dataset : public QObject {
 		QList<QString> m_bodypartsList;
 		QList<QString> m_entitiesList;
 		ColorMap *m_colorMap;
+		KeypointStore *m_keypointStore = nullptr;
+		QList<AnnotationContainer*> m_containers;
+		QList<QSet<int>> m_dirtyImgSets;
+		DatasetWriter *m_writer = nullptr;
+		QThread *m_writerThread = nullptr;
 };
 
 #endif
@@ -8,6 +8,7 @@
  ******************************************************************************/
 
 #include "datasetcreator.hpp"
+#include "datasetindex.hpp"
 
 #include <QFile>
 #include <QDir>
@@ -381,6 +382,8 @@ void DatasetCreator::createSavefile(const QString& recording,
 		 }
 		 file.close();
 	}
+	DatasetIndex::invalidate(m_datasetConfig->datasetPath + "/" +
+				m_datasetConfig->datasetName, dataFolder);
 }
 
 
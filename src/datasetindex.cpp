@@ -0,0 +1,215 @@
+/*******************************************************************************
+ * File:			  datasetindex.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "datasetindex.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QMutex>
+#include <QDataStream>
+#include <QDateTime>
+
+
+static const quint32 indexMagic = 0x4A494458;	//"JIDX"
+static const quint32 indexVersion = 2;
+//Dataset writers and the export list save indices from different threads
+static QMutex saveMutex;
+
+
+DatasetIndex::DatasetIndex(const QString& datasetBaseFolder,
+			const QString& datasetFolder) :
+			m_path(indexPath(datasetBaseFolder, datasetFolder)),
+			m_datasetFolder(datasetFolder) {
+}
+
+
+QString DatasetIndex::indexPath(const QString& datasetBaseFolder,
+			const QString& datasetFolder) {
+	QString relativePath = QDir(datasetBaseFolder).relativeFilePath(datasetFolder);
+	if (datasetBaseFolder == "" || relativePath.startsWith("..") ||
+				QDir::isAbsolutePath(relativePath)) {
+		return datasetFolder + "/.jarvis/segment.index";
+	}
+	if (relativePath == ".") relativePath = "";
+	return datasetBaseFolder + "/.jarvis/" + relativePath.replace("/", "_") +
+				".index";
+}
+
+
+void DatasetIndex::invalidate(const QString& datasetBaseFolder,
+			const QString& datasetFolder) {
+	QFile::remove(indexPath(datasetBaseFolder, datasetFolder));
+}
+
+
+QList<DatasetIndex::KeypointCount> DatasetIndex::countKeypoints(
+			const AnnotationContainer& container) {
+	QList<KeypointCount> counts(container.numKeypoints());
+	for (int i = 0; i < container.numKeypoints(); i++) {
+		counts[i].entity = container.entity(i);
+		counts[i].bodypart = container.bodypart(i);
+	}
+	for (int row = 0; row < container.numRows(); row++) {
+		const uint8_t *states = container.states(row);
+		for (int i = 0; i < container.numKeypoints(); i++) {
+			if (states[i] == Annotated) counts[i].count.annotated++;
+			else if (states[i] == Reprojected) counts[i].count.reprojected++;
+			else if (states[i] == NotAnnotated) counts[i].count.notAnnotated++;
+		}
+	}
+	return counts;
+}
+
+
+bool DatasetIndex::load() {
+	m_cameras.clear();
+	m_modified = false;
+	QFile file(m_path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return false;
+	}
+	QDataStream in(&file);
+	in.setVersion(QDataStream::Qt_6_0);
+	quint32 magic, version;
+	in >> magic >> version;
+	if (magic != indexMagic || version != indexVersion) {
+		return false;
+	}
+	qint32 numCameras;
+	in >> numCameras;
+	for (int cam = 0; cam < numCameras && in.status() == QDataStream::Ok; cam++) {
+		QString cameraName;
+		CameraEntry camera;
+		qint32 frameCount, numKeypoints, numFrames;
+		in >> cameraName >> camera.csvSize >> camera.csvModified >> frameCount >>
+					numKeypoints;
+		camera.frameCount = frameCount;
+		for (int i = 0; i < numKeypoints && in.status() == QDataStream::Ok; i++) {
+			KeypointCount keypoint;
+			qint32 annotated, reprojected, notAnnotated;
+			in >> keypoint.entity >> keypoint.bodypart >> annotated >> reprojected >>
+						notAnnotated;
+			keypoint.count.annotated = annotated;
+			keypoint.count.reprojected = reprojected;
+			keypoint.count.notAnnotated = notAnnotated;
+			camera.keypointCounts.append(keypoint);
+		}
+		in >> numFrames;
+		camera.frames.reserve(numFrames);
+		for (int i = 0; i < numFrames && in.status() == QDataStream::Ok; i++) {
+			QString frameName;
+			FrameEntry frame;
+			qint32 width, height;
+			in >> frameName >> width >> height >> frame.fileSize >> frame.modified;
+			frame.imageDimensions = QSize(width, height);
+			camera.frames.insert(frameName, frame);
+		}
+		m_cameras.insert(cameraName, camera);
+	}
+	if (in.status() != QDataStream::Ok) {
+		m_cameras.clear();
+		return false;
+	}
+	return true;
+}
+
+
+bool DatasetIndex::save() {
+	QMutexLocker locker(&saveMutex);
+	QDir().mkpath(QFileInfo(m_path).absolutePath());
+	QSaveFile file(m_path);
+	if (!file.open(QIODevice::WriteOnly)) {
+		return false;
+	}
+	QDataStream out(&file);
+	out.setVersion(QDataStream::Qt_6_0);
+	out << indexMagic << indexVersion << static_cast<qint32>(m_cameras.size());
+	for (auto it = m_cameras.constBegin(); it != m_cameras.constEnd(); ++it) {
+		const CameraEntry& camera = it.value();
+		out << it.key() << camera.csvSize << camera.csvModified <<
+					static_cast<qint32>(camera.frameCount) <<
+					static_cast<qint32>(camera.keypointCounts.size());
+		for (const auto& keypoint : camera.keypointCounts) {
+			out << keypoint.entity << keypoint.bodypart <<
+						static_cast<qint32>(keypoint.count.annotated) <<
+						static_cast<qint32>(keypoint.count.reprojected) <<
+						static_cast<qint32>(keypoint.count.notAnnotated);
+		}
+		out << static_cast<qint32>(camera.frames.size());
+		for (auto frame = camera.frames.constBegin();
+					frame != camera.frames.constEnd(); ++frame) {
+			out << frame.key() <<
+						static_cast<qint32>(frame.value().imageDimensions.width()) <<
+						static_cast<qint32>(frame.value().imageDimensions.height()) <<
+						frame.value().fileSize << frame.value().modified;
+		}
+	}
+	if (out.status() != QDataStream::Ok || !file.commit()) {
+		return false;
+	}
+	m_modified = false;
+	return true;
+}
+
+
+bool DatasetIndex::imageDimensions(const QString& camera,
+			const QString& frameName, const QFileInfo& imageInfo,
+			QSize *imageDimensions) const {
+	auto cameraIt = m_cameras.constFind(camera);
+	if (cameraIt == m_cameras.constEnd()) return false;
+	auto frameIt = cameraIt.value().frames.constFind(frameName);
+	if (frameIt == cameraIt.value().frames.constEnd()) return false;
+	if (frameIt.value().fileSize != imageInfo.size() || frameIt.value().modified !=
+				imageInfo.lastModified().toMSecsSinceEpoch()) {
+		return false;
+	}
+	*imageDimensions = frameIt.value().imageDimensions;
+	return true;
+}
+
+
+void DatasetIndex::setImageDimensions(const QString& camera,
+			const QString& frameName, const QFileInfo& imageInfo,
+			const QSize& imageDimensions) {
+	FrameEntry frame;
+	frame.imageDimensions = imageDimensions;
+	frame.fileSize = imageInfo.size();
+	frame.modified = imageInfo.lastModified().toMSecsSinceEpoch();
+	m_cameras[camera].frames.insert(frameName, frame);
+	m_modified = true;
+}
+
+
+bool DatasetIndex::keypointCounts(const QString& camera,
+			QList<KeypointCount> *counts, int *frameCount) const {
+	auto cameraIt = m_cameras.constFind(camera);
+	if (cameraIt == m_cameras.constEnd()) return false;
+	QFileInfo csvInfo(m_datasetFolder + "/" + camera + "/annotations.csv");
+	if (!csvInfo.exists() || cameraIt.value().csvSize != csvInfo.size() ||
+				cameraIt.value().csvModified !=
+				csvInfo.lastModified().toMSecsSinceEpoch()) {
+		return false;
+	}
+	*counts = cameraIt.value().keypointCounts;
+	*frameCount = cameraIt.value().frameCount;
+	return true;
+}
+
+
+void DatasetIndex::setKeypointCounts(const QString& camera,
+			const QList<KeypointCount>& counts, int frameCount) {
+	QFileInfo csvInfo(m_datasetFolder + "/" + camera + "/annotations.csv");
+	CameraEntry &entry = m_cameras[camera];
+	entry.csvSize = csvInfo.size();
+	entry.csvModified = csvInfo.lastModified().toMSecsSinceEpoch();
+	entry.keypointCounts = counts;
+	entry.frameCount = frameCount;
+	m_modified = true;
+}
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * File:			  datasetindex.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef DATASETINDEX_H
+#define DATASETINDEX_H
+
+#include "globals.hpp"
+#include "annotationcontainer.hpp"
+
+#include <QFileInfo>
+#include <QHash>
+#include <QMap>
+
+
+// Per segment cache of everything that is expensive to gather when opening a
+// dataset: the dimensions of every frame image and the annotation counts of
+// every keypoint of every camera, so totals for any selection of entities and
+// bodyparts can be summed up without reading a single csv row. Index files
+// live in a hidden .jarvis folder next to the dataset YAML, one per segment.
+//
+// Entries are only trusted while the size and modification time of the file
+// they were taken from still match, so reopening costs one stat per image
+// instead of opening and parsing every JPEG header.
+//
+// Saving replaces the index file in a single rename and saves of all indices
+// are serialized, so a crash or two owners of the same index saving at once
+// never leave a torn file behind. The last save wins, stale entries it might
+// bring back fail the check above and are gathered again.
+class DatasetIndex {
+	public:
+		explicit DatasetIndex(const QString& datasetBaseFolder,
+					const QString& datasetFolder);
+
+		bool load();
+		bool save();
+		bool isModified() const {return m_modified;}
+		static void invalidate(const QString& datasetBaseFolder,
+					const QString& datasetFolder);
+		static QString indexPath(const QString& datasetBaseFolder,
+					const QString& datasetFolder);
+		struct KeypointCount {
+			QString entity;
+			QString bodypart;
+			AnnotationCount count;
+		};
+		static QList<KeypointCount> countKeypoints(
+					const AnnotationContainer& container);
+
+		bool imageDimensions(const QString& camera, const QString& frameName,
+					const QFileInfo& imageInfo, QSize *imageDimensions) const;
+		void setImageDimensions(const QString& camera, const QString& frameName,
+					const QFileInfo& imageInfo, const QSize& imageDimensions);
+		bool keypointCounts(const QString& camera, QList<KeypointCount> *counts,
+					int *frameCount) const;
+		void setKeypointCounts(const QString& camera,
+					const QList<KeypointCount>& counts, int frameCount);
+
+	private:
+		struct FrameEntry {
+			QSize imageDimensions;
+			qint64 fileSize = -1;
+			qint64 modified = -1;
+		};
+		struct CameraEntry {
+			qint64 csvSize = -1;
+			qint64 csvModified = -1;
+			QList<KeypointCount> keypointCounts;
+			int frameCount = 0;
+			QHash<QString, FrameEntry> frames;
+		};
+
+		QString m_path;
+		QString m_datasetFolder;
+		QMap<QString, CameraEntry> m_cameras;
+		bool m_modified = false;
+};
+
+#endif
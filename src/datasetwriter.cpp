@@ -0,0 +1,314 @@
+/*******************************************************************************
+ * File:			  datasetwriter.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "datasetwriter.hpp"
+#include "profiler.hpp"
+
+#include <QFile>
+#include <QDir>
+#include <QSaveFile>
+
+#include <cstdio>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+
+
+DatasetWriter::DatasetWriter(const QString& datasetFolder,
+			const QList<QString>& cameraNames, const QByteArray& csvHeader,
+			const QList<QList<QString>>& frameNames, int numKeypoints,
+			const QList<QList<qint64>>& rowOffsets,
+			const QList<AnnotationContainer*>& containers, DatasetIndex *index) :
+			m_datasetFolder(datasetFolder), m_cameraNames(cameraNames),
+			m_csvHeader(csvHeader), m_frameNames(frameNames),
+			m_numKeypoints(numKeypoints), m_rowOffsets(rowOffsets), m_containers(containers), m_index(index),
+			m_journal(datasetFolder) {
+	m_journal.open(frameNames.value(0).size(), cameraNames.size(), numKeypoints);
+	for (int cam = 0; cam < cameraNames.size(); cam++) {
+		m_storedRows.append(QMap<int, Row>());
+	}
+}
+
+
+void DatasetWriter::appendJournalSlot(EditJournal::Record record) {
+	m_journal.append(record, false);
+	//Records that are already queued are appended before the sync runs
+	if (!m_journalSyncScheduled) {
+		m_journalSyncScheduled = true;
+		QMetaObject::invokeMethod(this, "syncJournalSlot", Qt::QueuedConnection);
+	}
+}
+
+
+void DatasetWriter::syncJournalSlot() {
+	m_journalSyncScheduled = false;
+	m_journal.sync();
+}
+
+
+void DatasetWriter::storeSnapshotSlot(AnnotationSnapshotPtr snapshot) {
+	PROFILE_SCOPE("Dataset write");
+	for (const auto& camera : snapshot->cameras) {
+		for (int i = 0; i < camera.rows.size(); i++) {
+			const int row = camera.rows[i];
+			const size_t start = static_cast<size_t>(i)*m_numKeypoints;
+			Row &stored = m_storedRows[camera.cameraIndex][row];
+			stored.x.assign(camera.x.begin() + start,
+						camera.x.begin() + start + m_numKeypoints);
+			stored.y.assign(camera.y.begin() + start,
+						camera.y.begin() + start + m_numKeypoints);
+			stored.states.assign(camera.states.begin() + start,
+						camera.states.begin() + start + m_numKeypoints);
+		}
+	}
+	//Every edit in the snapshot has been journaled before it was queued
+	m_storedJournalPosition = m_journal.position();
+}
+
+
+void DatasetWriter::compactSlot() {
+	PROFILE_SCOPE("Dataset compaction");
+	if (!recoverCommit(m_datasetFolder, m_cameraNames)) {
+		emit writeFailed();
+		return;
+	}
+	//Every csv is written next to the old one before any of them is replaced
+	QList<int> cameras;
+	QMap<int, QList<qint64>> rowOffsets;
+	bool success = true;
+	for (int cam = 0; cam < m_cameraNames.size() && success; cam++) {
+		if (m_storedRows[cam].isEmpty()) continue;
+		QString path = AnnotationContainer::csvPath(m_datasetFolder + "/" +
+					m_cameraNames[cam]);
+		QByteArray previousCSV;
+		QFile previousFile(path);
+		if (previousFile.open(QIODevice::ReadOnly)) {
+			previousCSV = previousFile.readAll();
+			previousFile.close();
+		}
+		QByteArray csv;
+		success = formatCSV(cam, m_storedRows[cam], previousCSV, &csv,
+					&rowOffsets[cam]) && writePendingCSV(pendingPath(path), csv);
+		cameras.append(cam);
+	}
+	QList<QString> cameraNames;
+	for (const auto& cam : cameras) cameraNames.append(m_cameraNames[cam]);
+	if (!success || (!cameras.isEmpty() &&
+				!writeCommitMarker(m_datasetFolder, cameraNames))) {
+		for (const auto& cameraName : cameraNames) {
+			QFile::remove(pendingPath(AnnotationContainer::csvPath(m_datasetFolder +
+						"/" + cameraName)));
+		}
+		emit writeFailed();
+		return;
+	}
+	//Once the marker is written the commit is completed by whoever gets to it
+	//first, this compaction or the recovery on the next load
+	if (!cameras.isEmpty() && !recoverCommit(m_datasetFolder, m_cameraNames)) {
+		emit writeFailed();
+		return;
+	}
+
+	for (const auto& cam : cameras) {
+		m_rowOffsets[cam] = rowOffsets[cam];
+		AnnotationContainer *cameraContainer = container(cam);
+		if (cameraContainer != nullptr) {
+			//The container follows the csv, never runs ahead of it
+			for (auto row = m_storedRows[cam].constBegin();
+						row != m_storedRows[cam].constEnd(); ++row) {
+				cameraContainer->storeRow(row.key(), row->x.data(), row->y.data(),
+							row->states.data());
+			}
+			cameraContainer->setCsvRowOffsets(rowOffsets[cam]);
+			//Rows have to be on disk before the stamp claims they match the csv
+			if (cameraContainer->sync()) cameraContainer->updateCsvStamp();
+			//Counted from what was written, without a container the index entry
+			//no longer matches the csv and is counted again by its next reader
+			m_index->setKeypointCounts(m_cameraNames[cam],
+						DatasetIndex::countKeypoints(*cameraContainer),
+						cameraContainer->numRows());
+		}
+		m_storedRows[cam].clear();
+	}
+	if (m_index->isModified()) m_index->save();
+	//Everything journaled before the last stored snapshot is in the csvs now
+	m_journal.discard(m_storedJournalPosition);
+}
+
+
+// Finishes a commit that was interrupted after its marker was written by
+// renaming the remaining pending csvs into place. Pending csvs without a
+// marker belong to a commit that never started, their edits are still in
+// the journal.
+bool DatasetWriter::recoverCommit(const QString& datasetFolder,
+			const QList<QString>& cameraNames) {
+	QFile marker(commitMarkerPath(datasetFolder));
+	if (!marker.open(QIODevice::ReadOnly)) {
+		for (const auto& cameraName : cameraNames) {
+			QFile::remove(pendingPath(AnnotationContainer::csvPath(datasetFolder +
+						"/" + cameraName)));
+		}
+		return true;
+	}
+	QList<QByteArray> committedCameras = marker.readAll().split('\n');
+	marker.close();
+	for (const auto& cameraName : committedCameras) {
+		if (cameraName.isEmpty()) continue;
+		QString path = AnnotationContainer::csvPath(datasetFolder + "/" +
+					QString::fromUtf8(cameraName));
+		if (QFile::exists(pendingPath(path)) &&
+					!replaceFile(pendingPath(path), path)) {
+			return false;
+		}
+	}
+	return QFile::remove(commitMarkerPath(datasetFolder));
+}
+
+
+QString DatasetWriter::commitMarkerPath(const QString& datasetFolder) {
+	return datasetFolder + "/annotations.commit";
+}
+
+
+QString DatasetWriter::pendingPath(const QString& csvPath) {
+	return csvPath + ".pending";
+}
+
+
+bool DatasetWriter::writePendingCSV(const QString& path, const QByteArray& csv) {
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+				file.write(csv) != csv.size() || !file.flush()) {
+		return false;
+	}
+#ifdef Q_OS_WIN
+	return _commit(file.handle()) == 0;
+#else
+	return fsync(file.handle()) == 0;
+#endif
+}
+
+
+bool DatasetWriter::writeCommitMarker(const QString& datasetFolder,
+			const QList<QString>& cameraNames) {
+	QByteArray marker;
+	for (const auto& cameraName : cameraNames) {
+		marker.append(cameraName.toUtf8());
+		marker.append('\n');
+	}
+	QSaveFile file(commitMarkerPath(datasetFolder));
+	return file.open(QIODevice::WriteOnly) &&
+				file.write(marker) == marker.size() && file.commit();
+}
+
+
+bool DatasetWriter::replaceFile(const QString& source, const QString& target) {
+#ifdef Q_OS_WIN
+	return MoveFileExW(reinterpret_cast<LPCWSTR>(
+				QDir::toNativeSeparators(source).utf16()), reinterpret_cast<LPCWSTR>(
+				QDir::toNativeSeparators(target).utf16()),
+				MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+	return std::rename(QFile::encodeName(source).constData(),
+				QFile::encodeName(target).constData()) == 0;
+#endif
+}
+
+
+bool DatasetWriter::exportSnapshotSlot(const QString& dataFolder,
+			AnnotationSnapshotPtr snapshot) {
+	bool success = true;
+	for (const auto& camera : snapshot->cameras) {
+		QMap<int, Row> rows;
+		for (int i = 0; i < camera.rows.size(); i++) {
+			const size_t start = static_cast<size_t>(i)*m_numKeypoints;
+			Row &row = rows[camera.rows[i]];
+			row.x.assign(camera.x.begin() + start,
+						camera.x.begin() + start + m_numKeypoints);
+			row.y.assign(camera.y.begin() + start,
+						camera.y.begin() + start + m_numKeypoints);
+			row.states.assign(camera.states.begin() + start,
+						camera.states.begin() + start + m_numKeypoints);
+		}
+		QByteArray csv;
+		QList<qint64> rowOffsets;
+		success = formatCSV(camera.cameraIndex, rows, QByteArray(), &csv,
+					&rowOffsets) && writeCSV(AnnotationContainer::csvPath(dataFolder +
+					"/" + m_cameraNames[camera.cameraIndex]), csv) && success;
+	}
+	return success;
+}
+
+
+AnnotationContainer *DatasetWriter::container(int cameraIndex) const {
+	AnnotationContainer *cameraContainer = m_containers.value(cameraIndex);
+	if (cameraContainer == nullptr || !cameraContainer->isOpen() ||
+				cameraContainer->numRows() != m_frameNames[cameraIndex].size() ||
+				cameraContainer->numKeypoints() != m_numKeypoints) {
+		return nullptr;
+	}
+	return cameraContainer;
+}
+
+
+bool DatasetWriter::formatCSV(int cameraIndex, const QMap<int, Row>& rows,
+			const QByteArray& previousCSV, QByteArray *csv,
+			QList<qint64> *rowOffsets) const {
+	const int numImgSets = m_frameNames[cameraIndex].size();
+	const QList<qint64>& previousOffsets = m_rowOffsets[cameraIndex];
+	AnnotationContainer *cameraContainer = container(cameraIndex);
+	bool reuseRows = !previousCSV.isEmpty() &&
+				previousOffsets.size() == numImgSets+1 &&
+				previousOffsets.last() == previousCSV.size();
+	csv->clear();
+	csv->reserve(reuseRows ? previousCSV.size() + 1024 : m_csvHeader.size());
+	if (reuseRows) {
+		csv->append(previousCSV.constData(), previousOffsets[0]);
+	}
+	else {
+		csv->append(m_csvHeader);
+	}
+	for (int row = 0; row < numImgSets; row++) {
+		rowOffsets->append(csv->size());
+		const QString& frameName = m_frameNames[cameraIndex][row];
+		auto stored = rows.constFind(row);
+		if (stored != rows.constEnd()) {
+			csv->append(AnnotationContainer::formatRow(frameName,
+						stored->x.data(), stored->y.data(), stored->states.data(),
+						m_numKeypoints));
+		}
+		else if (reuseRows) {
+			csv->append(previousCSV.constData() + previousOffsets[row],
+						previousOffsets[row+1] - previousOffsets[row]);
+		}
+		else if (cameraContainer != nullptr) {
+			//The csv changed under us, the container still has every row
+			csv->append(AnnotationContainer::formatRow(frameName,
+						cameraContainer->x(row), cameraContainer->y(row),
+						cameraContainer->states(row), m_numKeypoints));
+		}
+		else {
+			return false;
+		}
+	}
+	rowOffsets->append(csv->size());
+	return true;
+}
+
+
+bool DatasetWriter::writeCSV(const QString& path, const QByteArray& csv) {
+	QSaveFile file(path);
+	return file.open(QIODevice::WriteOnly) && file.write(csv) == csv.size() &&
+				file.commit();
+}
@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * File:			  datasetwriter.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef DATASETWRITER_H
+#define DATASETWRITER_H
+
+#include "globals.hpp"
+#include "annotationcontainer.hpp"
+#include "datasetindex.hpp"
+#include "editjournal.hpp"
+
+#include <QSharedPointer>
+#include <QMap>
+
+#include <vector>
+
+
+// Rows that changed since the last snapshot, for every camera that has any.
+// Only ever read once it has been handed to the writer. Coordinates of
+// keypoints that are not annotated or reprojected are NaN, as in
+// AnnotationContainer.
+struct AnnotationSnapshot {
+	struct Camera {
+		int cameraIndex;
+		QList<int> rows;
+		std::vector<float> x;				//[row][keypoint], rows in the order of rows
+		std::vector<float> y;
+		std::vector<uint8_t> states;
+	};
+
+	QList<Camera> cameras;
+};
+
+typedef QSharedPointer<const AnnotationSnapshot> AnnotationSnapshotPtr;
+Q_DECLARE_METATYPE(AnnotationSnapshotPtr)
+
+
+// Persists annotation snapshots on its own thread. Saving a snapshot only
+// keeps its rows until the next compaction, the edits themselves are already
+// safe in the edit journal. So the cost of a save only depends on the number
+// of edited rows.
+//
+// Compaction writes the csvs of all cameras with stored rows. Rows that did
+// not change are copied from the previous csv instead of being formatted
+// again. The csvs of all cameras are first written and synced next to the
+// originals as pending files. Only then a commit marker listing the cameras
+// is written next to the journal and the pending files are renamed over the
+// originals. A commit that is interrupted after the marker was written is
+// finished by recoverCommit() on the next compaction or load, pending files
+// without a marker are dropped. So readers never see a partially written
+// csv and the cameras of a segment are never left out of sync. The journal
+// is only discarded once the commit is complete.
+//
+// After loading, the annotation containers, the segment index and the edit
+// journal of a dataset belong to its writer, which keeps them in sync with the
+// csvs. Journal records are appended as they arrive and synced once per
+// burst, so the GUI thread never waits for the disk. A snapshot is always
+// queued behind the records of the edits it contains.
+class DatasetWriter : public QObject {
+	Q_OBJECT
+
+	public:
+		explicit DatasetWriter(const QString& datasetFolder,
+					const QList<QString>& cameraNames, const QByteArray& csvHeader,
+					const QList<QList<QString>>& frameNames, int numKeypoints,
+					const QList<QList<qint64>>& rowOffsets,
+					const QList<AnnotationContainer*>& containers, DatasetIndex *index);
+
+		static bool recoverCommit(const QString& datasetFolder,
+					const QList<QString>& cameraNames);
+
+	signals:
+		void writeFailed();
+
+	public slots:
+		void appendJournalSlot(EditJournal::Record record);
+		void syncJournalSlot();
+		void storeSnapshotSlot(AnnotationSnapshotPtr snapshot);
+		void compactSlot();
+		bool exportSnapshotSlot(const QString& dataFolder,
+					AnnotationSnapshotPtr snapshot);
+
+	private:
+		struct Row {
+			std::vector<float> x;
+			std::vector<float> y;
+			std::vector<uint8_t> states;
+		};
+
+		AnnotationContainer *container(int cameraIndex) const;
+		bool formatCSV(int cameraIndex, const QMap<int, Row>& rows,
+					const QByteArray& previousCSV, QByteArray *csv,
+					QList<qint64> *rowOffsets) const;
+		static bool writeCSV(const QString& path, const QByteArray& csv);
+		static QString commitMarkerPath(const QString& datasetFolder);
+		static QString pendingPath(const QString& csvPath);
+		static bool writePendingCSV(const QString& path, const QByteArray& csv);
+		static bool writeCommitMarker(const QString& datasetFolder,
+					const QList<QString>& cameraNames);
+		static bool replaceFile(const QString& source, const QString& target);
+
+		QString m_datasetFolder;
+		QList<QString> m_cameraNames;
+		QByteArray m_csvHeader;
+		QList<QList<QString>> m_frameNames;
+		int m_numKeypoints;
+		QList<QList<qint64>> m_rowOffsets;
+		QList<AnnotationContainer*> m_containers;
+		DatasetIndex *m_index;
+		EditJournal m_journal;
+		bool m_journalSyncScheduled = false;
+		QList<QMap<int, Row>> m_storedRows;		//[camera][row], not in the csv yet
+		qint64 m_storedJournalPosition = 0;
+};
+
+#endif
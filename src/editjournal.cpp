@@ -0,0 +1,202 @@
+/*******************************************************************************
+ * File:			  editjournal.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "editjournal.hpp"
+
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+
+static const char journalMagic[8] = {'J','A','R','V','I','S','E','J'};
+static const quint32 journalVersion = 1;
+static const int headerSize = 24;
+static const int recordSize = 18;
+
+
+static quint8 checksum(const char *data, int size) {
+	quint8 sum = 0x5A;
+	for (int i = 0; i < size; i++) {
+		sum = static_cast<quint8>((sum << 1 | sum >> 7) ^ static_cast<quint8>(data[i]));
+	}
+	return sum;
+}
+
+
+EditJournal::EditJournal(const QString& datasetFolder) {
+	m_file.setFileName(journalPath(datasetFolder));
+}
+
+
+QString EditJournal::journalPath(const QString& datasetFolder) {
+	return datasetFolder + "/annotations.journal";
+}
+
+
+bool EditJournal::open(int numImgSets, int numCameras, int numKeypoints) {
+	close();
+	m_numImgSets = numImgSets;
+	m_numCameras = numCameras;
+	m_numKeypoints = numKeypoints;
+	if (!m_file.open(QIODevice::ReadWrite)) {
+		return false;
+	}
+	m_basePosition = 0;
+	if (m_file.read(headerSize) != header()) {
+		//Missing, foreign or belonging to a different layout of the segment
+		bool success = reset();
+		m_basePosition = 0;
+		return success;
+	}
+	return m_file.seek(m_file.size());
+}
+
+
+void EditJournal::close() {
+	if (m_file.isOpen()) {
+		m_file.close();
+	}
+}
+
+
+bool EditJournal::isEmpty() const {
+	return !m_file.isOpen() || m_file.size() <= headerSize;
+}
+
+
+int EditJournal::replay(const std::function<void(const Record&)>& apply) {
+	if (!m_file.isOpen() || !m_file.seek(headerSize)) return 0;
+	QByteArray data = m_file.readAll();
+	int numRecords = 0;
+	qint64 validSize = headerSize;
+	for (qint64 pos = 0; pos + recordSize <= data.size(); pos += recordSize) {
+		const char *raw = data.constData() + pos;
+		if (checksum(raw, recordSize-1) != static_cast<quint8>(raw[recordSize-1])) {
+			break;
+		}
+		quint32 imgSetIndex;
+		quint16 frameIndex, keypointId;
+		Record record;
+		std::memcpy(&imgSetIndex, raw, 4);
+		std::memcpy(&frameIndex, raw+4, 2);
+		std::memcpy(&keypointId, raw+6, 2);
+		std::memcpy(&record.x, raw+8, 4);
+		std::memcpy(&record.y, raw+12, 4);
+		quint8 state = static_cast<quint8>(raw[16]);
+		if (imgSetIndex >= m_numImgSets || frameIndex >= m_numCameras ||
+					keypointId >= m_numKeypoints || state > Suppressed) {
+			break;
+		}
+		record.imgSetIndex = imgSetIndex;
+		record.frameIndex = frameIndex;
+		record.keypointId = keypointId;
+		record.state = static_cast<KeypointState>(state);
+		apply(record);
+		numRecords++;
+		validSize += recordSize;
+	}
+	//Drop a record torn by a crash so new edits are appended behind valid ones
+	if (validSize != m_file.size()) {
+		m_file.resize(validSize);
+	}
+	m_file.seek(validSize);
+	return numRecords;
+}
+
+
+bool EditJournal::append(const Record& record, bool sync) {
+	if (!m_file.isOpen()) return false;
+	char raw[recordSize];
+	quint32 imgSetIndex = record.imgSetIndex;
+	quint16 frameIndex = record.frameIndex;
+	quint16 keypointId = record.keypointId;
+	std::memcpy(raw, &imgSetIndex, 4);
+	std::memcpy(raw+4, &frameIndex, 2);
+	std::memcpy(raw+6, &keypointId, 2);
+	std::memcpy(raw+8, &record.x, 4);
+	std::memcpy(raw+12, &record.y, 4);
+	raw[16] = static_cast<char>(record.state);
+	raw[17] = static_cast<char>(checksum(raw, recordSize-1));
+	if (m_file.write(raw, recordSize) != recordSize) {
+		return false;
+	}
+	return !sync || this->sync();
+}
+
+
+bool EditJournal::sync() {
+	if (!m_file.isOpen() || !m_file.flush()) return false;
+#ifdef Q_OS_WIN
+	return _commit(m_file.handle()) == 0;
+#elif defined(Q_OS_LINUX)
+	return fdatasync(m_file.handle()) == 0;
+#else
+	return fsync(m_file.handle()) == 0;
+#endif
+}
+
+
+bool EditJournal::reset() {
+	if (!m_file.isOpen()) return false;
+	m_basePosition = position();
+	if (!m_file.resize(0) || !m_file.seek(0)) {
+		return false;
+	}
+	QByteArray journalHeader = header();
+	return m_file.write(journalHeader) == journalHeader.size() && sync();
+}
+
+
+qint64 EditJournal::position() const {
+	if (!m_file.isOpen()) return m_basePosition;
+	return m_basePosition + std::max<qint64>(m_file.size() - headerSize, 0);
+}
+
+
+bool EditJournal::discard(qint64 position) {
+	if (!m_file.isOpen() || position <= m_basePosition) return true;
+	if (position >= this->position()) return reset();
+
+	//Records written after the snapshot are kept. The shortened journal
+	//replaces the old one in a single rename.
+	if (!m_file.seek(headerSize + position - m_basePosition)) return false;
+	QByteArray remaining = m_file.readAll();
+	QSaveFile file(m_file.fileName());
+	if (!file.open(QIODevice::WriteOnly) || file.write(header()) != headerSize ||
+				file.write(remaining) != remaining.size()) {
+		m_file.seek(m_file.size());
+		return false;
+	}
+	m_file.close();
+	bool success = file.commit();
+	if (m_file.open(QIODevice::ReadWrite)) {
+		m_file.seek(m_file.size());
+	}
+	if (success) m_basePosition = position;
+	return success;
+}
+
+
+QByteArray EditJournal::header() const {
+	QByteArray journalHeader(headerSize, '\0');
+	char *data = journalHeader.data();
+	std::memcpy(data, journalMagic, 8);
+	std::memcpy(data+8, &journalVersion, 4);
+	std::memcpy(data+12, &m_numImgSets, 4);
+	std::memcpy(data+16, &m_numCameras, 4);
+	std::memcpy(data+20, &m_numKeypoints, 4);
+	return journalHeader;
+}
@@ -0,0 +1,64 @@
+/*******************************************************************************
+ * File:			  editjournal.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef EDITJOURNAL_H
+#define EDITJOURNAL_H
+
+#include "globals.hpp"
+
+#include <QFile>
+#include <QMetaType>
+
+#include <functional>
+
+
+// Append-only redo log of keypoint edits (annotations.journal in the segment
+// folder). Every record holds the state of one keypoint after an edit and is
+// synced to disk soon after, so edits survive a crash between two saves.
+// Records are replayed on top of the csvs on the next load. Once the csvs have
+// been written, the records up to the position recorded with the snapshot
+// are discarded. Positions are logical and stay valid across discards.
+class EditJournal {
+	public:
+		struct Record {
+			int imgSetIndex;
+			int frameIndex;
+			int keypointId;
+			float x;
+			float y;
+			KeypointState state;
+		};
+
+		explicit EditJournal(const QString& datasetFolder);
+
+		bool open(int numImgSets, int numCameras, int numKeypoints);
+		void close();
+		bool isOpen() const {return m_file.isOpen();}
+		bool isEmpty() const;
+		int replay(const std::function<void(const Record&)>& apply);
+		bool append(const Record& record, bool sync = true);
+		bool sync();
+		bool reset();
+		qint64 position() const;
+		bool discard(qint64 position);
+
+		static QString journalPath(const QString& datasetFolder);
+
+	private:
+		QByteArray header() const;
+
+		QFile m_file;
+		qint64 m_basePosition = 0;
+		quint32 m_numImgSets = 0;
+		quint32 m_numCameras = 0;
+		quint32 m_numKeypoints = 0;
+};
+Q_DECLARE_METATYPE(EditJournal::Record)
+
+#endif
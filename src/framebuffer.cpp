@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * File:			  framebuffer.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "framebuffer.hpp"
+
+#include <QImageReader>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+
+FrameBuffer::FrameBuffer(int width, int height, Format format) {
+	if (width <= 0 || height <= 0 || format == Invalid) return;
+	const int bytesPerPixel = format == Gray8 ? 1 : 4;
+	m_width = width;
+	m_height = height;
+	m_format = format;
+	m_bytesPerLine = (width*bytesPerPixel + Alignment - 1)/Alignment*Alignment;
+	uchar *data = static_cast<uchar*>(::operator new(sizeInBytes(),
+				std::align_val_t(Alignment)));
+	m_data = std::shared_ptr<uchar>(data, [](uchar *data) {
+				::operator delete(data, std::align_val_t(Alignment));});
+}
+
+
+FrameBuffer::Format FrameBuffer::formatFor(QImage::Format format) {
+	return format == QImage::Format_Grayscale8 ? Gray8 : RGB32;
+}
+
+
+FrameBuffer FrameBuffer::fromImage(const QImage& image) {
+	if (image.isNull()) return FrameBuffer();
+	const Format format = formatFor(image.format());
+	const QImage source = image.format() == QImage::Format_Grayscale8 ||
+				image.format() == QImage::Format_RGB32 ? image :
+				image.convertToFormat(QImage::Format_RGB32);
+	FrameBuffer buffer(source.width(), source.height(), format);
+	const qsizetype rowBytes = std::min<qsizetype>(source.bytesPerLine(),
+				buffer.bytesPerLine());
+	for (int row = 0; row < source.height(); row++) {
+		std::memcpy(buffer.scanLine(row), source.constScanLine(row), rowBytes);
+	}
+	return buffer;
+}
+
+
+FrameBuffer FrameBuffer::decode(const QString& path, int scaleDenominator,
+			QSize *imageSize) {
+	QImageReader reader(path);
+	const QSize size = reader.size();
+	if (imageSize != nullptr) *imageSize = size;
+	QSize targetSize = size;
+	//The JPEG plugin turns the scaled size into a DCT domain scale factor
+	if (scaleDenominator > 1 && size.isValid()) {
+		targetSize = QSize(std::max(1, size.width()/scaleDenominator),
+					std::max(1, size.height()/scaleDenominator));
+		reader.setScaledSize(targetSize);
+	}
+
+	//Decoders that produce one of our formats write straight into the buffer,
+	//anything else is decoded by Qt and converted once
+	const QImage::Format imageFormat = reader.imageFormat();
+	if (targetSize.isValid() && (imageFormat == QImage::Format_Grayscale8 ||
+				imageFormat == QImage::Format_RGB32)) {
+		FrameBuffer buffer(targetSize.width(), targetSize.height(),
+					formatFor(imageFormat));
+		QImage target = buffer.toImage();
+		if (reader.read(&target) && target.constBits() == buffer.constBits()) {
+			return buffer;
+		}
+		if (target.isNull()) return FrameBuffer();
+		if (imageSize != nullptr && !size.isValid()) *imageSize = target.size();
+		return fromImage(target);
+	}
+	QImage image = reader.read();
+	if (imageSize != nullptr && !size.isValid() && !image.isNull()) {
+		*imageSize = image.size();
+	}
+	return fromImage(image);
+}
+
+
+static void releaseFrameBuffer(void *info) {
+	delete static_cast<std::shared_ptr<uchar>*>(info);
+}
+
+
+QImage FrameBuffer::toImage() const {
+	if (isNull()) return QImage();
+	return QImage(m_data.get(), m_width, m_height, m_bytesPerLine,
+				m_format == Gray8 ? QImage::Format_Grayscale8 : QImage::Format_RGB32,
+				releaseFrameBuffer, new std::shared_ptr<uchar>(m_data));
+}
+
+
+cv::Mat FrameBuffer::toMat() const {
+	if (isNull()) return cv::Mat();
+	return cv::Mat(m_height, m_width, m_format == Gray8 ? CV_8UC1 : CV_8UC4,
+				m_data.get(), m_bytesPerLine);
+}
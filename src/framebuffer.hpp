@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * File:			  framebuffer.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include "globals.hpp"
+
+#include <QImage>
+
+#include <opencv2/core.hpp>
+
+#include <memory>
+
+
+// Reference counted pixel buffer of a decoded frame, either 8 bit grayscale
+// or 32 bit 0xffRRGGBB (QImage::Format_RGB32, CV_8UC4 in BGRA byte order).
+// Rows are padded to a multiple of 64 bytes and the buffer is 64 byte aligned.
+//
+// toImage() and toMat() wrap the pixels without copying them. QImages keep
+// the buffer alive on their own, a cv::Mat does not own its data and is only
+// valid as long as a FrameBuffer or QImage referencing the pixels exists.
+// Copies of a FrameBuffer share the pixels, writing through any of them is
+// visible in all.
+class FrameBuffer {
+	public:
+		enum Format {Invalid, Gray8, RGB32};
+		static const int Alignment = 64;
+
+		FrameBuffer() = default;
+		FrameBuffer(int width, int height, Format format);
+		static FrameBuffer fromImage(const QImage& image);
+		static FrameBuffer decode(const QString& path, int scaleDenominator = 1,
+					QSize *imageSize = nullptr);
+		static Format formatFor(QImage::Format format);
+
+		bool isNull() const {return m_data == nullptr;}
+		int width() const {return m_width;}
+		int height() const {return m_height;}
+		QSize size() const {return QSize(m_width, m_height);}
+		Format format() const {return m_format;}
+		int bytesPerLine() const {return m_bytesPerLine;}
+		qint64 sizeInBytes() const {return static_cast<qint64>(m_bytesPerLine)*m_height;}
+		uchar *bits() {return m_data.get();}
+		const uchar *constBits() const {return m_data.get();}
+		uchar *scanLine(int row) {return m_data.get() + static_cast<qint64>(row)*m_bytesPerLine;}
+		const uchar *constScanLine(int row) const {
+			return m_data.get() + static_cast<qint64>(row)*m_bytesPerLine;
+		}
+
+		QImage toImage() const;
+		cv::Mat toMat() const;
+
+	private:
+		std::shared_ptr<uchar> m_data;
+		int m_width = 0;
+		int m_height = 0;
+		int m_bytesPerLine = 0;
+		Format m_format = Invalid;
+};
+
+#endif
@@ -0,0 +1,191 @@
+/*******************************************************************************
+ * File:			  imageadjustment.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "imageadjustment.hpp"
+
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+
+//Frames from the ImageCache already are Grayscale8 or RGB32, anything else
+//is converted once
+static QImage toNativeFormat(const QImage& image) {
+	if (image.format() == QImage::Format_Grayscale8 ||
+				image.format() == QImage::Format_RGB32) {
+		return image;
+	}
+	return image.convertToFormat(QImage::Format_RGB32);
+}
+
+
+//Splits the rows into one block per core, the calling thread takes the first
+static void forEachRowBlock(int numRows,
+			const std::function<void(int block, int begin, int end)>& function) {
+	const int numBlocks = std::max(1, std::min(QThread::idealThreadCount(),
+				numRows/32));
+	QSemaphore finished;
+	for (int block = 1; block < numBlocks; block++) {
+		int begin = numRows*block/numBlocks;
+		int end = numRows*(block+1)/numBlocks;
+		QThreadPool::globalInstance()->start([&function, &finished, block, begin, end]() {
+			function(block, begin, end);
+			finished.release();
+		});
+	}
+	function(0, 0, numRows/numBlocks);
+	finished.acquire(numBlocks-1);
+}
+
+
+int ImageAdjustment::meanBrightness(const QImage& image) {
+	if (image.isNull()) return 0;
+	const QImage source = toNativeFormat(image);
+	const int width = source.width();
+	const bool gray = source.format() == QImage::Format_Grayscale8;
+	std::vector<qint64> sums(QThread::idealThreadCount()+1, 0);
+	forEachRowBlock(source.height(), [&](int block, int begin, int end) {
+		qint64 sum = 0;
+		for (int row = begin; row < end; row++) {
+			if (gray) {
+				const uchar *line = source.constScanLine(row);
+				for (int i = 0; i < width; i++) sum += line[i];
+				continue;
+			}
+			const QRgb *line = reinterpret_cast<const QRgb*>(source.constScanLine(row));
+			for (int i = 0; i < width; i++) {
+				sum += std::max(std::max(qRed(line[i]), qGreen(line[i])), qBlue(line[i]));
+			}
+		}
+		sums[block] = sum;
+	});
+	qint64 total = 0;
+	for (const auto& sum : sums) total += sum;
+	return static_cast<int>(total/(static_cast<qint64>(width)*source.height()));
+}
+
+
+QImage ImageAdjustment::apply(const QImage& image, int meanBrightness) const {
+	if (image.isNull() || isIdentity()) return image;
+	FrameBuffer target;
+	apply(image, meanBrightness, &target);
+	return target.toImage();
+}
+
+
+void ImageAdjustment::apply(const QImage& image, int meanBrightness,
+			FrameBuffer *target) const {
+	if (image.isNull()) {
+		*target = FrameBuffer();
+		return;
+	}
+	const QImage source = toNativeFormat(image);
+	const FrameBuffer::Format format = FrameBuffer::formatFor(source.format());
+	if (target->size() != source.size() || target->format() != format) {
+		*target = FrameBuffer(source.width(), source.height(), format);
+	}
+	FrameBuffer& result = *target;
+	const int width = source.width();
+
+	//Same arithmetic as the former per pixel QColor implementation
+	int valueLUT[256];
+	int saturationLUT[256];
+	const double contrast = m_contrastFactor/100.;
+	for (int i = 0; i < 256; i++) {
+		int v = static_cast<int>((i-meanBrightness)*contrast + meanBrightness);
+		valueLUT[i] = std::max(0, std::min(v*m_brightnessFactor*m_brightnessFactor/10000, 255));
+		saturationLUT[i] = std::min(i*m_saturationFactor/100, 255);
+	}
+
+	if (format == FrameBuffer::Gray8) {
+		//Gray pixels have no hue and saturation, only the value changes
+		uchar grayLUT[256];
+		for (int i = 0; i < 256; i++) grayLUT[i] = static_cast<uchar>(valueLUT[i]);
+		forEachRowBlock(source.height(), [&](int, int begin, int end) {
+			for (int row = begin; row < end; row++) {
+				const uchar *in = source.constScanLine(row);
+				uchar *out = result.scanLine(row);
+				for (int i = 0; i < width; i++) out[i] = grayLUT[in[i]];
+			}
+		});
+		return;
+	}
+
+	if (m_hueFactor == 0 && m_saturationFactor == 100) {
+		//Scaling all channels by valueLUT[v]/v keeps hue and saturation
+		quint32 scale[256];
+		quint32 offset[256];
+		scale[0] = 0;
+		offset[0] = valueLUT[0];
+		for (int v = 1; v < 256; v++) {
+			scale[v] = (static_cast<quint32>(valueLUT[v]) << 16)/v;
+			offset[v] = 0;
+		}
+		forEachRowBlock(source.height(), [&](int, int begin, int end) {
+			for (int row = begin; row < end; row++) {
+				const QRgb *in = reinterpret_cast<const QRgb*>(source.constScanLine(row));
+				QRgb *out = reinterpret_cast<QRgb*>(result.scanLine(row));
+				for (int i = 0; i < width; i++) {
+					quint32 r = qRed(in[i]), g = qGreen(in[i]), b = qBlue(in[i]);
+					quint32 v = std::max(std::max(r, g), b);
+					quint32 s = scale[v], o = offset[v];
+					r = ((r*s + 32768) >> 16) + o;
+					g = ((g*s + 32768) >> 16) + o;
+					b = ((b*s + 32768) >> 16) + o;
+					out[i] = 0xff000000 | (r << 16) | (g << 8) | b;
+				}
+			}
+		});
+		return;
+	}
+
+	const int hueShift = ((m_hueFactor%360)+360)%360;
+	forEachRowBlock(source.height(), [&](int, int begin, int end) {
+		for (int row = begin; row < end; row++) {
+			const QRgb *in = reinterpret_cast<const QRgb*>(source.constScanLine(row));
+			QRgb *out = reinterpret_cast<QRgb*>(result.scanLine(row));
+			for (int i = 0; i < width; i++) {
+				int r = qRed(in[i]), g = qGreen(in[i]), b = qBlue(in[i]);
+				int max = std::max(std::max(r, g), b);
+				int min = std::min(std::min(r, g), b);
+				int delta = max - min;
+				int v = valueLUT[max];
+				int s = max == 0 ? 0 : saturationLUT[(255*delta + max/2)/max];
+				if (s == 0 || delta == 0) {
+					out[i] = 0xff000000 | (v << 16) | (v << 8) | v;
+					continue;
+				}
+				int h;
+				if (max == r) h = (60*(g - b))/delta;
+				else if (max == g) h = 120 + (60*(b - r))/delta;
+				else h = 240 + (60*(r - g))/delta;
+				h = (h + 360 + hueShift)%360;
+
+				int region = h/60;
+				int remainder = (h - region*60)*255/60;
+				int p = v*(255 - s)/255;
+				int q = v*(255 - s*remainder/255)/255;
+				int t = v*(255 - s*(255 - remainder)/255)/255;
+				switch (region) {
+					case 0: r = v; g = t; b = p; break;
+					case 1: r = q; g = v; b = p; break;
+					case 2: r = p; g = v; b = t; break;
+					case 3: r = p; g = q; b = v; break;
+					case 4: r = t; g = p; b = v; break;
+					default: r = v; g = p; b = q; break;
+				}
+				out[i] = 0xff000000 | (r << 16) | (g << 8) | b;
+			}
+		}
+	});
+}
@@ -0,0 +1,50 @@
+/*******************************************************************************
+ * File:			  imageadjustment.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef IMAGEADJUSTMENT_H
+#define IMAGEADJUSTMENT_H
+
+#include "globals.hpp"
+#include "framebuffer.hpp"
+
+#include <QImage>
+
+
+// Hue, saturation, brightness and contrast adjustment of the editor images.
+// Contrast and brightness act on the HSV value through a 256 entry lookup
+// table, saturation through a second one. If hue and saturation are left
+// untouched the channels are simply rescaled, which keeps hue and saturation
+// of every pixel and avoids the HSV round trip. Rows are processed in
+// parallel on the global thread pool, straight on the scanlines. Grayscale
+// frames stay grayscale and only go through the value table.
+class ImageAdjustment {
+	public:
+		ImageAdjustment(int hueFactor, int saturationFactor, int brightnessFactor,
+					int contrastFactor) :
+					m_hueFactor(hueFactor), m_saturationFactor(saturationFactor),
+					m_brightnessFactor(brightnessFactor), m_contrastFactor(contrastFactor) {}
+
+		bool isIdentity() const {
+			return m_hueFactor == 0 && m_saturationFactor == 100 &&
+						 m_brightnessFactor == 100 && m_contrastFactor == 100;
+		}
+		QImage apply(const QImage& image, int meanBrightness) const;
+		//Writes into target, which is only reallocated if size or format changed
+		void apply(const QImage& image, int meanBrightness, FrameBuffer *target) const;
+
+		static int meanBrightness(const QImage& image);
+
+	private:
+		int m_hueFactor;
+		int m_saturationFactor;
+		int m_brightnessFactor;
+		int m_contrastFactor;
+};
+
+#endif
@@ -0,0 +1,278 @@
+/*******************************************************************************
+ * File:			  imagecache.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "imagecache.hpp"
+#include "framebuffer.hpp"
+#include "profiler.hpp"
+
+#include <QSettings>
+#include <QRunnable>
+#include <QThread>
+
+#include <algorithm>
+
+
+class ImageDecoder : public QRunnable {
+	public:
+		ImageDecoder(ImageCache *cache, const QString& path, bool preview = false) :
+					m_cache(cache), m_path(path), m_preview(preview) {}
+		void run() override {
+			if (m_preview) {
+				m_cache->decodePreview(m_path);
+			}
+			else {
+				m_cache->decode(m_path);
+			}
+		}
+
+	private:
+		ImageCache *m_cache;
+		QString m_path;
+		bool m_preview;
+};
+
+
+ImageCache::ImageCache(qint64 budgetBytes, QObject *parent) : QObject(parent) {
+	m_cache.setMaxCost(budgetBytes);
+	m_previewCache.setMaxCost(budgetBytes/(PreviewScaleDenominator*PreviewScaleDenominator));
+	m_threadPool.setMaxThreadCount(std::max(2, QThread::idealThreadCount()/2));
+	m_prefetchPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount()/2));
+}
+
+
+ImageCache::~ImageCache() {
+	m_prefetchPool.clear();
+	m_threadPool.clear();
+	m_prefetchPool.waitForDone();
+	m_threadPool.waitForDone();
+}
+
+
+ImageCache *ImageCache::instance() {
+	static ImageCache *cache = nullptr;
+	if (cache == nullptr) {
+		QSettings settings;
+		qint64 budgetMB = settings.value("Settings/ImageSettings/cacheSize",
+					DefaultBudgetMB).toLongLong();
+		cache = new ImageCache(budgetMB*1024*1024, QCoreApplication::instance());
+	}
+	return cache;
+}
+
+
+QImage ImageCache::image(const QString& path) {
+	QMutexLocker locker(&m_mutex);
+	while (m_inFlight.contains(path)) {
+		m_decoded.wait(&m_mutex);
+	}
+	if (QImage *cached = m_cache.object(path)) {
+		return *cached;
+	}
+	m_inFlight.insert(path);
+	locker.unlock();
+	QImage image;
+	{
+		PROFILE_SCOPE("Image decode");
+		image = FrameBuffer::decode(path).toImage();
+	}
+	locker.relock();
+	m_inFlight.remove(path);
+	insert(path, image);
+	m_decoded.wakeAll();
+	if (m_requested.remove(path) && !image.isNull()) {
+		//Not emitted from within the caller, which is usually the GUI thread
+		QMetaObject::invokeMethod(this, [this, path] {emit imageDecoded(path);},
+					Qt::QueuedConnection);
+	}
+	return image;
+}
+
+
+QImage ImageCache::cachedImage(const QString& path) {
+	QMutexLocker locker(&m_mutex);
+	if (QImage *cached = m_cache.object(path)) {
+		m_statistics.hits++;
+		return *cached;
+	}
+	m_statistics.misses++;
+	return QImage();
+}
+
+
+bool ImageCache::contains(const QString& path) const {
+	QMutexLocker locker(&m_mutex);
+	return m_cache.contains(path);
+}
+
+
+QImage ImageCache::decodeScaled(const QString& path, int scaleDenominator,
+			QSize *imageSize) {
+	PROFILE_SCOPE("Preview decode");
+	return FrameBuffer::decode(path, scaleDenominator, imageSize).toImage();
+}
+
+
+QImage ImageCache::preview(const QString& path, QSize *imageSize) {
+	QMutexLocker locker(&m_mutex);
+	if (QImage *cached = m_cache.object(path)) {
+		if (imageSize != nullptr) *imageSize = cached->size();
+		return *cached;
+	}
+	if (Preview *cached = m_previewCache.object(path)) {
+		if (imageSize != nullptr) *imageSize = cached->imageSize;
+		return cached->image;
+	}
+	locker.unlock();
+	Preview *preview = new Preview;
+	preview->image = decodeScaled(path, PreviewScaleDenominator, &preview->imageSize);
+	if (imageSize != nullptr) *imageSize = preview->imageSize;
+	QImage image = preview->image;
+	locker.relock();
+	if (image.isNull()) {
+		delete preview;
+	}
+	else {
+		m_previewCache.insert(path, preview, image.sizeInBytes());
+	}
+	return image;
+}
+
+
+QImage ImageCache::cachedPreview(const QString& path, QSize *imageSize) {
+	QMutexLocker locker(&m_mutex);
+	if (Preview *cached = m_previewCache.object(path)) {
+		if (imageSize != nullptr) *imageSize = cached->imageSize;
+		return cached->image;
+	}
+	if (QImage *cached = m_cache.object(path)) {
+		if (imageSize != nullptr) *imageSize = cached->size();
+		return *cached;
+	}
+	return QImage();
+}
+
+
+void ImageCache::requestImage(const QString& path) {
+	{
+		QMutexLocker locker(&m_mutex);
+		if (!m_cache.contains(path)) {
+			//A decode that is already running emits imageDecoded when it is done,
+			//whoever started it
+			if (m_inFlight.contains(path)) {
+				m_requested.insert(path);
+			}
+			else {
+				m_threadPool.start(new ImageDecoder(this, path), 1);
+			}
+			return;
+		}
+	}
+	emit imageDecoded(path);
+}
+
+
+void ImageCache::requestPreviews(const QList<QString>& paths) {
+	QMutexLocker locker(&m_mutex);
+	for (const auto& path : paths) {
+		if (m_previewCache.contains(path) || m_cache.contains(path)) continue;
+		m_threadPool.start(new ImageDecoder(this, path, true), 2);
+	}
+}
+
+
+void ImageCache::decodePreview(const QString& path) {
+	if (!preview(path).isNull()) emit previewDecoded(path);
+}
+
+
+void ImageCache::prefetch(const QList<QString>& paths) {
+	//Predictions that are not being decoded yet are outdated
+	m_prefetchPool.clear();
+	QMutexLocker locker(&m_mutex);
+	for (const auto& path : paths) {
+		if (m_cache.contains(path) || m_inFlight.contains(path)) continue;
+		m_prefetchPool.start(new ImageDecoder(this, path));
+	}
+}
+
+
+void ImageCache::decode(const QString& path) {
+	{
+		QMutexLocker locker(&m_mutex);
+		while (m_inFlight.contains(path)) {
+			m_decoded.wait(&m_mutex);
+		}
+		if (m_cache.contains(path)) {
+			locker.unlock();
+			emit imageDecoded(path);
+			return;
+		}
+		m_inFlight.insert(path);
+	}
+	QImage image;
+	{
+		PROFILE_SCOPE("Image decode (background)");
+		image = FrameBuffer::decode(path).toImage();
+	}
+	{
+		QMutexLocker locker(&m_mutex);
+		m_inFlight.remove(path);
+		m_requested.remove(path);
+		if (!image.isNull()) {
+			insert(path, image);
+			m_statistics.prefetched++;
+		}
+		m_decoded.wakeAll();
+	}
+	if (!image.isNull()) emit imageDecoded(path);
+}
+
+
+void ImageCache::insert(const QString& path, const QImage& image) {
+	if (image.isNull()) return;
+	//Images larger than the whole budget are not cached
+	m_cache.insert(path, new QImage(image), image.sizeInBytes());
+}
+
+
+void ImageCache::setMemoryBudget(qint64 budgetBytes) {
+	QMutexLocker locker(&m_mutex);
+	m_cache.setMaxCost(budgetBytes);
+	m_previewCache.setMaxCost(budgetBytes/(PreviewScaleDenominator*PreviewScaleDenominator));
+}
+
+
+qint64 ImageCache::memoryBudget() const {
+	QMutexLocker locker(&m_mutex);
+	return m_cache.maxCost();
+}
+
+
+ImageCache::Statistics ImageCache::statistics() const {
+	QMutexLocker locker(&m_mutex);
+	Statistics statistics = m_statistics;
+	statistics.usedBytes = m_cache.totalCost();
+	statistics.budgetBytes = m_cache.maxCost();
+	statistics.numImages = m_cache.count();
+	return statistics;
+}
+
+
+void ImageCache::resetStatistics() {
+	QMutexLocker locker(&m_mutex);
+	m_statistics = Statistics();
+}
+
+
+void ImageCache::clear() {
+	m_prefetchPool.clear();
+	QMutexLocker locker(&m_mutex);
+	m_cache.clear();
+	m_previewCache.clear();
+}
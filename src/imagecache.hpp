@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * File:			  imagecache.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include "globals.hpp"
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QSet>
+#include <QThreadPool>
+#include <QWaitCondition>
+
+
+// Least recently used cache of decoded frames, shared by everything in the
+// editor that displays images. The cost of an entry is the size of its pixel
+// data, entries are evicted once the memory budget is exceeded.
+//
+// prefetch() decodes the given images on worker threads of their own, a new
+// prediction replaces all decodes of the previous one that did not start yet.
+// Decodes and previews requested for display run on a separate pool and are
+// never dropped that way. image() waits for a decode that is already running
+// instead of starting a second one.
+//
+// preview() returns a copy of the image that is downscaled while decoding,
+// which for JPEGs happens in the DCT domain and takes a fraction of the time
+// of a full decode. requestImage() decodes the full image in the background
+// and emits imageDecoded() once it is in the cache, also when the image was
+// already being decoded by someone else. requestPreviews() does the same for
+// previews and emits previewDecoded().
+//
+// Hits and misses are counted by cachedImage(), which returns a null image
+// instead of decoding, so they reflect how often a frame was ready when it
+// was shown.
+class ImageCache : public QObject {
+	Q_OBJECT
+
+	public:
+		struct Statistics {
+			qint64 hits = 0;
+			qint64 misses = 0;
+			qint64 prefetched = 0;
+			qint64 usedBytes = 0;
+			qint64 budgetBytes = 0;
+			int numImages = 0;
+		};
+
+		static const int DefaultBudgetMB = 1024;
+		static const int PreviewScaleDenominator = 4;
+
+		explicit ImageCache(qint64 budgetBytes, QObject *parent = nullptr);
+		~ImageCache();
+		static ImageCache *instance();
+
+		QImage image(const QString& path);
+		QImage cachedImage(const QString& path);
+		bool contains(const QString& path) const;
+		QImage preview(const QString& path, QSize *imageSize = nullptr);
+		QImage cachedPreview(const QString& path, QSize *imageSize = nullptr);
+		void requestImage(const QString& path);
+		void requestPreviews(const QList<QString>& paths);
+		void prefetch(const QList<QString>& paths);
+		void setMemoryBudget(qint64 budgetBytes);
+		qint64 memoryBudget() const;
+		Statistics statistics() const;
+		void resetStatistics();
+		void clear();
+
+		static QImage decodeScaled(const QString& path, int scaleDenominator,
+					QSize *imageSize = nullptr);
+
+	signals:
+		void imageDecoded(const QString& path);
+		void previewDecoded(const QString& path);
+
+	private:
+		struct Preview {
+			QImage image;
+			QSize imageSize;
+		};
+
+		friend class ImageDecoder;
+		void decode(const QString& path);
+		void decodePreview(const QString& path);
+		void insert(const QString& path, const QImage& image);
+
+		mutable QMutex m_mutex;
+		QWaitCondition m_decoded;
+		QCache<QString, QImage> m_cache;
+		QCache<QString, Preview> m_previewCache;
+		QSet<QString> m_inFlight;
+		QSet<QString> m_requested;		//in flight, imageDecoded is owed
+		QThreadPool m_threadPool;
+		QThreadPool m_prefetchPool;
+		Statistics m_statistics;
+};
+
+#endif
@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * File:			  imagepyramid.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "imagepyramid.hpp"
+
+#include <algorithm>
+
+
+void ImagePyramid::setImage(const QImage& image, const QSize& imageSize) {
+	m_levels.clear();
+	m_numLevels = 0;
+	if (image.isNull()) return;
+	m_levels.append(image);
+	m_imageSize = imageSize.isValid() ? imageSize : image.size();
+	int width = image.width();
+	int height = image.height();
+	m_numLevels = 1;
+	while (width/2 >= MinLevelSize && height/2 >= MinLevelSize) {
+		width /= 2;
+		height /= 2;
+		m_numLevels++;
+	}
+}
+
+
+void ImagePyramid::clear() {
+	m_levels.clear();
+	m_numLevels = 0;
+}
+
+
+int ImagePyramid::levelForScale(float scale) const {
+	//Smallest level that still has at least one pixel per screen pixel
+	if (m_numLevels > 0) {
+		scale *= static_cast<float>(m_imageSize.width())/m_levels[0].width();
+	}
+	int level = 0;
+	while (level+1 < m_numLevels && scale <= 1.0f/(1 << (level+1))) {
+		level++;
+	}
+	return level;
+}
+
+
+const QImage& ImagePyramid::level(int level) {
+	level = std::max(0, std::min(level, m_numLevels-1));
+	while (m_levels.size() <= level) {
+		const QImage& previous = m_levels.last();
+		m_levels.append(previous.scaled(previous.width()/2, previous.height()/2,
+					Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+	}
+	return m_levels[level];
+}
+
+
+QRectF ImagePyramid::mapToLevel(const QRectF& rect, int level) {
+	const QImage& image = this->level(level);
+	const double scaleX = static_cast<double>(image.width())/m_imageSize.width();
+	const double scaleY = static_cast<double>(image.height())/m_imageSize.height();
+	return QRectF(rect.x()*scaleX, rect.y()*scaleY, rect.width()*scaleX,
+				rect.height()*scaleY);
+}
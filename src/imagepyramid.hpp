@@ -0,0 +1,45 @@
+/*******************************************************************************
+ * File:			  imagepyramid.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef IMAGEPYRAMID_H
+#define IMAGEPYRAMID_H
+
+#include "globals.hpp"
+
+#include <QImage>
+#include <QRectF>
+
+
+// Successively halved copies of an image. Level 0 is the image itself, the
+// smaller levels are created on first use and kept until the image is
+// replaced. Painting from the level closest to the displayed size keeps the
+// cost of a repaint proportional to the screen area instead of the image.
+// The image can be a downscaled preview standing in for a larger image, all
+// rects and scales are given in coordinates of that larger image. Scales are
+// device pixels per image pixel, so they include the device pixel ratio.
+class ImagePyramid {
+	public:
+		static const int MinLevelSize = 64;
+
+		void setImage(const QImage& image, const QSize& imageSize = QSize());
+		void clear();
+		bool isNull() const {return m_levels.isEmpty();}
+
+		int numLevels() const {return m_numLevels;}
+		int levelForScale(float scale) const;
+		const QImage& level(int level);
+		QRectF mapToLevel(const QRectF& rect, int level);
+
+	private:
+		QList<QImage> m_levels;
+		int m_numLevels = 0;
+		QSize m_imageSize;
+};
+
+#endif
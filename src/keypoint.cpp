@@ -10,30 +10,33 @@
 #include "keypoint.hpp"
 
 
-Keypoint::Keypoint(QString entity,QString bodypart, QColor color,
-			QPointF coordinates) : m_entity(entity), m_bodypart(bodypart),
-			m_color(color), m_coordinates(coordinates) {
-	m_ID = m_entity + "/" + m_bodypart;
+void Keypoint::setCoordinates(QPointF point, bool transient) {
+	m_store->setCoordinates(m_imgSetIndex, m_frameIndex, m_id, point.x(), point.y(),
+				transient);
 }
 
-Keypoint::~Keypoint() {
+
+void Keypoint::setCoordinates(float x, float y) {
+	m_store->setCoordinates(m_imgSetIndex, m_frameIndex, m_id, x, y);
 }
 
 
-void Keypoint::setCoordinates(QPointF point) {
-	m_coordinates = point;
+void Keypoint::commitCoordinates() {
+	m_store->commitCoordinates(m_imgSetIndex, m_frameIndex, m_id);
 }
 
 
 void Keypoint::setState(KeypointState state) {
-	if (m_state != state) {
-		if (m_state == Reprojected) {
-			m_color.setAlpha(100);
-		}
-		else if (m_state == Annotated) {
-			m_color.setAlpha(255);
-		}
-		emit stateChanged(state, m_state, m_frameIndex);
-		m_state = state;
-	}
+	m_store->setState(m_imgSetIndex, m_frameIndex, m_id, state);
+}
+
+
+Keypoint Frame::keypoint(int id) const {
+	return Keypoint(keypointStore, imgSetIndex, frameIndex, id);
+}
+
+
+Keypoint Frame::keypoint(const QString& id) const {
+	return Keypoint(keypointStore, imgSetIndex, frameIndex,
+				keypointStore->keypointId(id));
 }
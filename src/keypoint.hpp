@@ -11,50 +11,55 @@
 #define KEYPOINT_H
 
 #include "globals.hpp"
+#include "keypointstore.hpp"
 
 
-class Keypoint : public QObject {
-	Q_OBJECT
-
+// Lightweight handle to a single keypoint inside a KeypointStore. Handles are
+// cheap to copy and don't own any data, all reads and writes go straight to
+// the store.
+class Keypoint {
 	public:
-		explicit Keypoint(QString entity,
-											QString bopdypart,
-											QColor color = QColor(255,255,255),
-											QPointF coordinates = QPointF(0,0));
-		~Keypoint();
+		Keypoint() = default;
+		Keypoint(KeypointStore *store, int imgSetIndex, int frameIndex, int id) :
+					m_store(store), m_imgSetIndex(imgSetIndex),
+					m_frameIndex(frameIndex), m_id(id) {}
 
-		void setCoordinates(QPointF coords);
+		bool isValid() const {return m_store != nullptr && m_id >= 0;}
+		void setCoordinates(QPointF coords, bool transient = false);
 		void setCoordinates(float x, float y);
-		QPointF coordinates() const {return m_coordinates;}
-		float rx()  {return m_coordinates.rx();}
-		float ry()  {return m_coordinates.ry();}
+		void commitCoordinates();
+		QPointF coordinates() const {return QPointF(rx(), ry());}
+		float rx() const {return m_store->x(index());}
+		float ry() const {return m_store->y(index());}
 		void setState(KeypointState state);
-		const KeypointState& state() const {return m_state;}
-		QString entity() const {return m_entity;}
-		QString bodypart() const {return m_bodypart;}
-		QString ID() const {return m_ID;}
-		void setColor(QColor color) {m_color = color;}
-		QColor color() const {return m_color;}
-		void setShowName(bool show) {m_showName = show;}
-		bool showName() const {return m_showName;}
-		void setFrameIndex(int frameIndex) {m_frameIndex = frameIndex;}
+		KeypointState state() const {return m_store->state(index());}
+		const QString& entity() const {return m_store->entity(m_id);}
+		const QString& bodypart() const {return m_store->bodypart(m_id);}
+		const QString& ID() const {return m_store->ID(m_id);}
+		int entityIndex() const {return m_store->entityIndex(m_id);}
+		int bodypartIndex() const {return m_store->bodypartIndex(m_id);}
+		QColor color() const {return m_store->color(m_id);}
 		int frameIndex() const {return m_frameIndex;}
+		int imgSetIndex() const {return m_imgSetIndex;}
+		int id() const {return m_id;}
 
-	signals:
-		void stateChanged(KeypointState state, KeypointState previousState,
-					int frameIndex);
+		friend bool operator== (const Keypoint &lhs, const Keypoint &rhs) {
+			return lhs.m_store == rhs.m_store && lhs.m_id == rhs.m_id &&
+						 lhs.m_imgSetIndex == rhs.m_imgSetIndex &&
+						 lhs.m_frameIndex == rhs.m_frameIndex;
+		}
+		friend bool operator!= (const Keypoint &lhs, const Keypoint &rhs) {
+			return !(lhs == rhs);
+		}
 
 	private:
-		KeypointState m_state = NotAnnotated;
-		QString m_entity;
-		QString m_bodypart;
-		QColor m_color;
-		QPointF m_coordinates{0,0};
-		QString m_ID;
-		bool m_reprojected = false;
-		bool m_showName = false;
-		bool m_isSuppessed = false;
+		int index() const {return m_store->index(m_imgSetIndex, m_frameIndex, m_id);}
+
+		KeypointStore *m_store = nullptr;
+		int m_imgSetIndex = 0;
 		int m_frameIndex = 0;
+		int m_id = -1;
 };
+Q_DECLARE_METATYPE(Keypoint)
 
 #endif
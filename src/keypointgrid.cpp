@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * File:			  keypointgrid.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "keypointgrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+void KeypointGrid::build(const KeypointStore *store, int imgSetIndex,
+			int frameIndex, const QSize& imageSize, float cellSize) {
+	m_store = store;
+	m_imgSetIndex = imgSetIndex;
+	m_frameIndex = frameIndex;
+	const float minCellSize = std::sqrt(static_cast<float>(imageSize.width())*
+				imageSize.height()/(std::max(1, store->numKeypoints())*MaxCellsPerKeypoint));
+	m_cellSize = std::max({cellSize, minCellSize, 1.0f});
+	m_columns = std::max(1, static_cast<int>(std::ceil(imageSize.width()/m_cellSize)));
+	m_rows = std::max(1, static_cast<int>(std::ceil(imageSize.height()/m_cellSize)));
+	m_cells.assign(m_columns*m_rows, {});
+	m_keypointCells.assign(store->numKeypoints(), -1);
+	m_positions.assign(store->numKeypoints(), QPointF());
+	for (int keypointId = 0; keypointId < store->numKeypoints(); keypointId++) {
+		insert(keypointId);
+	}
+}
+
+
+void KeypointGrid::clear() {
+	m_store = nullptr;
+	m_imgSetIndex = -1;
+	m_frameIndex = -1;
+	m_cells.clear();
+	m_keypointCells.clear();
+	m_positions.clear();
+}
+
+
+int KeypointGrid::column(float x) const {
+	return std::max(0, std::min(static_cast<int>(std::floor(x/m_cellSize)), m_columns-1));
+}
+
+
+int KeypointGrid::row(float y) const {
+	return std::max(0, std::min(static_cast<int>(std::floor(y/m_cellSize)), m_rows-1));
+}
+
+
+void KeypointGrid::insert(int keypointId) {
+	int idx = m_store->index(m_imgSetIndex, m_frameIndex, keypointId);
+	KeypointState state = m_store->state(idx);
+	float x = m_store->x(idx);
+	float y = m_store->y(idx);
+	if ((state != Annotated && state != Reprojected) || !std::isfinite(x) ||
+				!std::isfinite(y)) {
+		return;
+	}
+	int cell = cellIndex(column(x), row(y));
+	m_cells[cell].push_back(keypointId);
+	m_keypointCells[keypointId] = cell;
+	m_positions[keypointId] = QPointF(x, y);
+}
+
+
+void KeypointGrid::remove(int keypointId) {
+	int cell = m_keypointCells[keypointId];
+	if (cell == -1) return;
+	std::vector<int>& keypoints = m_cells[cell];
+	auto it = std::find(keypoints.begin(), keypoints.end(), keypointId);
+	if (it != keypoints.end()) {
+		*it = keypoints.back();
+		keypoints.pop_back();
+	}
+	m_keypointCells[keypointId] = -1;
+}
+
+
+void KeypointGrid::update(int keypointId) {
+	if (m_store == nullptr || keypointId < 0 ||
+				keypointId >= static_cast<int>(m_keypointCells.size())) {
+		return;
+	}
+	remove(keypointId);
+	insert(keypointId);
+}
+
+
+int KeypointGrid::nearest(const QPointF& position, float radius,
+			int excludeId) const {
+	if (m_store == nullptr) return -1;
+	int nearestId = -1;
+	double nearestDistance = static_cast<double>(radius)*radius;
+	for (int r = row(position.y()-radius); r <= row(position.y()+radius); r++) {
+		for (int c = column(position.x()-radius); c <= column(position.x()+radius); c++) {
+			for (int keypointId : m_cells[cellIndex(c, r)]) {
+				if (keypointId == excludeId) continue;
+				QPointF delta = m_positions[keypointId] - position;
+				double distance = delta.x()*delta.x() + delta.y()*delta.y();
+				if (distance < nearestDistance) {
+					nearestDistance = distance;
+					nearestId = keypointId;
+				}
+			}
+		}
+	}
+	return nearestId;
+}
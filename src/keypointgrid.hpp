@@ -0,0 +1,62 @@
+/*******************************************************************************
+ * File:			  keypointgrid.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef KEYPOINTGRID_H
+#define KEYPOINTGRID_H
+
+#include "globals.hpp"
+#include "keypointstore.hpp"
+
+#include <QPointF>
+#include <QSize>
+
+#include <vector>
+
+
+// Uniform grid over the visible (annotated or reprojected) keypoints of one
+// frame, used for hit-testing mouse positions. Cells are about as large as a
+// keypoint, so a query only looks at the handful of keypoints around the
+// position. Small keypoints on large frames get larger cells, the grid never
+// has more than about MaxCellsPerKeypoint cells per keypoint. update() moves
+// a single keypoint after it changed in the store. Keypoints outside of the
+// image are kept in the border cells.
+class KeypointGrid {
+	public:
+		static const int MaxCellsPerKeypoint = 4;
+
+		void build(const KeypointStore *store, int imgSetIndex, int frameIndex,
+					const QSize& imageSize, float cellSize);
+		void clear();
+		bool isBuiltFor(int imgSetIndex, int frameIndex) const {
+			return m_store != nullptr && m_imgSetIndex == imgSetIndex &&
+						 m_frameIndex == frameIndex;
+		}
+
+		void update(int keypointId);
+		int nearest(const QPointF& position, float radius, int excludeId = -1) const;
+
+	private:
+		int cellIndex(int column, int row) const {return row*m_columns + column;}
+		int column(float x) const;
+		int row(float y) const;
+		void insert(int keypointId);
+		void remove(int keypointId);
+
+		const KeypointStore *m_store = nullptr;
+		int m_imgSetIndex = -1;
+		int m_frameIndex = -1;
+		float m_cellSize = 1.0f;
+		int m_columns = 0;
+		int m_rows = 0;
+		std::vector<std::vector<int>> m_cells;
+		std::vector<int> m_keypointCells;			//-1 if the keypoint is not visible
+		std::vector<QPointF> m_positions;
+};
+
+#endif
@@ -0,0 +1,149 @@
+/*******************************************************************************
+ * File:			  keypointstore.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "keypointstore.hpp"
+
+
+KeypointStore::KeypointStore(int numCameras, int numKeypoints, QObject *parent) :
+			QObject(parent), m_numCameras(numCameras), m_numKeypoints(numKeypoints) {
+	for (int i = 0; i < m_numKeypoints; i++) {
+		m_entities.append("");
+		m_bodyparts.append("");
+		m_IDs.append("");
+		m_colors.append(QColor(255,255,255));
+	}
+	m_keypointCounts.resize(static_cast<size_t>(m_numCameras)*m_numKeypoints*NumStates, 0);
+	m_entityIndices.resize(m_numKeypoints, -1);
+	m_bodypartIndices.resize(m_numKeypoints, -1);
+}
+
+
+void KeypointStore::setKeypointInfo(int keypointId, const QString& entity,
+			const QString& bodypart, QColor color) {
+	m_entities[keypointId] = entity;
+	m_bodyparts[keypointId] = bodypart;
+	m_IDs[keypointId] = entity + "/" + bodypart;
+	m_colors[keypointId] = color;
+	m_idMap[m_IDs[keypointId]] = keypointId;
+	if (!m_entityNames.contains(entity)) m_entityNames.append(entity);
+	if (!m_bodypartNames.contains(bodypart)) m_bodypartNames.append(bodypart);
+	m_entityIndices[keypointId] = m_entityNames.indexOf(entity);
+	m_bodypartIndices[keypointId] = m_bodypartNames.indexOf(bodypart);
+	buildIdTable();
+}
+
+
+void KeypointStore::buildIdTable() {
+	m_idTable.assign(static_cast<size_t>(numEntities())*numBodyparts(), -1);
+	for (int i = 0; i < m_numKeypoints; i++) {
+		if (m_entityIndices[i] < 0) continue;
+		m_idTable[m_entityIndices[i]*numBodyparts() + m_bodypartIndices[i]] = i;
+	}
+}
+
+
+int KeypointStore::addImgSet() {
+	size_t size = static_cast<size_t>(m_numImgSets+1)*m_numCameras*m_numKeypoints;
+	m_x.resize(size, 0.0f);
+	m_y.resize(size, 0.0f);
+	m_state.resize(size, NotAnnotated);
+	m_frameCounts.resize(static_cast<size_t>(m_numImgSets+1)*m_numCameras*NumStates, 0);
+	m_imgSetCounts.resize(static_cast<size_t>(m_numImgSets+1)*NumStates, 0);
+	for (int cam = 0; cam < m_numCameras; cam++) {
+		for (int i = 0; i < m_numKeypoints; i++) {
+			countState(m_numImgSets, cam, i, NotAnnotated, 1);
+		}
+	}
+	return m_numImgSets++;
+}
+
+
+void KeypointStore::initKeypoint(int imgSetIndex, int frameIndex, int keypointId,
+			float x, float y, KeypointState state) {
+	int idx = index(imgSetIndex, frameIndex, keypointId);
+	m_x[idx] = x;
+	m_y[idx] = y;
+	countState(imgSetIndex, frameIndex, keypointId, m_state[idx], -1);
+	countState(imgSetIndex, frameIndex, keypointId, state, 1);
+	m_state[idx] = state;
+}
+
+
+void KeypointStore::setCoordinates(int imgSetIndex, int frameIndex,
+			int keypointId, float x, float y, bool transient) {
+	int idx = index(imgSetIndex, frameIndex, keypointId);
+	if (m_x[idx] != x || m_y[idx] != y) {
+		m_x[idx] = x;
+		m_y[idx] = y;
+		emit keypointChanged(imgSetIndex, frameIndex, keypointId);
+		if (!transient) {
+			emit keypointEdited(imgSetIndex, frameIndex, keypointId, state(idx));
+		}
+	}
+}
+
+
+void KeypointStore::commitCoordinates(int imgSetIndex, int frameIndex,
+			int keypointId) {
+	int idx = index(imgSetIndex, frameIndex, keypointId);
+	emit keypointEdited(imgSetIndex, frameIndex, keypointId, state(idx));
+}
+
+
+void KeypointStore::setState(int imgSetIndex, int frameIndex, int keypointId,
+			KeypointState state) {
+	int idx = index(imgSetIndex, frameIndex, keypointId);
+	KeypointState previousState = static_cast<KeypointState>(m_state[idx]);
+	if (previousState != state) {
+		countState(imgSetIndex, frameIndex, keypointId, previousState, -1);
+		countState(imgSetIndex, frameIndex, keypointId, state, 1);
+		m_state[idx] = state;
+		emit stateChanged(state, previousState, imgSetIndex, frameIndex);
+		emit keypointChanged(imgSetIndex, frameIndex, keypointId);
+		emit keypointEdited(imgSetIndex, frameIndex, keypointId, previousState);
+	}
+}
+
+
+void KeypointStore::countState(int imgSetIndex, int frameIndex, int keypointId,
+			uint8_t state, int delta) {
+	m_frameCounts[(imgSetIndex*m_numCameras + frameIndex)*NumStates + state] += delta;
+	m_imgSetCounts[imgSetIndex*NumStates + state] += delta;
+	m_keypointCounts[(frameIndex*m_numKeypoints + keypointId)*NumStates + state] += delta;
+	m_totalCounts[state] += delta;
+}
+
+
+AnnotationCount KeypointStore::toAnnotationCount(const int *counts) {
+	AnnotationCount count;
+	count.notAnnotated = counts[NotAnnotated];
+	count.annotated = counts[Annotated];
+	count.reprojected = counts[Reprojected];
+	return count;
+}
+
+
+AnnotationCount KeypointStore::frameCount(int imgSetIndex, int frameIndex) const {
+	return toAnnotationCount(&m_frameCounts[(imgSetIndex*m_numCameras + frameIndex)*NumStates]);
+}
+
+
+AnnotationCount KeypointStore::imgSetCount(int imgSetIndex) const {
+	return toAnnotationCount(&m_imgSetCounts[imgSetIndex*NumStates]);
+}
+
+
+AnnotationCount KeypointStore::keypointCount(int frameIndex, int keypointId) const {
+	return toAnnotationCount(&m_keypointCounts[(frameIndex*m_numKeypoints + keypointId)*NumStates]);
+}
+
+
+AnnotationCount KeypointStore::totalCount() const {
+	return toAnnotationCount(m_totalCounts);
+}
@@ -0,0 +1,129 @@
+/*******************************************************************************
+ * File:			  keypointstore.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef KEYPOINTSTORE_H
+#define KEYPOINTSTORE_H
+
+#include "globals.hpp"
+
+#include <QHash>
+#include <QColor>
+#include <QPointF>
+
+#include <vector>
+
+
+// Columnar storage for all keypoints of a dataset. Coordinates and states live
+// in flat arrays indexed by [imgSet][camera][keypointId], the per keypoint
+// metadata (entity, bodypart, color) is only stored once per keypointId.
+// Entity and bodypart names are interned in order of first appearance, so
+// hot loops can address keypoints by (entityIndex, bodypartIndex) through a
+// dense table instead of building and hashing "entity/bodypart" strings.
+//
+// keypointChanged is emitted for every change, keypointEdited only for the
+// ones that have to be persisted. Coordinates set as transient (e.g. while a
+// keypoint is being dragged) are only reported as edited once they are
+// committed.
+//
+// The number of keypoints in every state is tracked per frame, per imgSet,
+// per camera and keypointId and for the whole segment. The counters are
+// updated on every state change, so reading them never rescans the arrays.
+class KeypointStore : public QObject {
+	Q_OBJECT
+
+	public:
+		explicit KeypointStore(int numCameras, int numKeypoints,
+					QObject *parent = nullptr);
+
+		void setKeypointInfo(int keypointId, const QString& entity,
+					const QString& bodypart, QColor color);
+		int addImgSet();
+		void initKeypoint(int imgSetIndex, int frameIndex, int keypointId,
+					float x, float y, KeypointState state);
+
+		int numImgSets() const {return m_numImgSets;}
+		int numCameras() const {return m_numCameras;}
+		int numKeypoints() const {return m_numKeypoints;}
+		int keypointId(const QString& id) const {return m_idMap.value(id, -1);}
+		const QString& entity(int keypointId) const {return m_entities[keypointId];}
+		const QString& bodypart(int keypointId) const {return m_bodyparts[keypointId];}
+		const QString& ID(int keypointId) const {return m_IDs[keypointId];}
+		QColor color(int keypointId) const {return m_colors[keypointId];}
+		int numEntities() const {return m_entityNames.size();}
+		int numBodyparts() const {return m_bodypartNames.size();}
+		const QString& entityName(int entityIndex) const {return m_entityNames[entityIndex];}
+		int entityIndex(int keypointId) const {return m_entityIndices[keypointId];}
+		int bodypartIndex(int keypointId) const {return m_bodypartIndices[keypointId];}
+		int entityIndex(const QString& entity) const {return m_entityNames.indexOf(entity);}
+		int bodypartIndex(const QString& bodypart) const {
+			return m_bodypartNames.indexOf(bodypart);
+		}
+		int keypointId(int entityIndex, int bodypartIndex) const {
+			if (entityIndex < 0 || bodypartIndex < 0 ||
+						entityIndex >= numEntities() || bodypartIndex >= numBodyparts()) {
+				return -1;
+			}
+			return m_idTable[entityIndex*numBodyparts() + bodypartIndex];
+		}
+
+		int index(int imgSetIndex, int frameIndex, int keypointId) const {
+			return (imgSetIndex*m_numCameras + frameIndex)*m_numKeypoints + keypointId;
+		}
+		float x(int idx) const {return m_x[idx];}
+		float y(int idx) const {return m_y[idx];}
+		KeypointState state(int idx) const {
+			return static_cast<KeypointState>(m_state[idx]);
+		}
+		AnnotationCount frameCount(int imgSetIndex, int frameIndex) const;
+		AnnotationCount imgSetCount(int imgSetIndex) const;
+		AnnotationCount keypointCount(int frameIndex, int keypointId) const;
+		AnnotationCount totalCount() const;
+		void setCoordinates(int imgSetIndex, int frameIndex, int keypointId,
+					float x, float y, bool transient = false);
+		void commitCoordinates(int imgSetIndex, int frameIndex, int keypointId);
+		void setState(int imgSetIndex, int frameIndex, int keypointId,
+					KeypointState state);
+
+	signals:
+		void stateChanged(KeypointState state, KeypointState previousState,
+					int imgSetIndex, int frameIndex);
+		void keypointChanged(int imgSetIndex, int frameIndex, int keypointId);
+		void keypointEdited(int imgSetIndex, int frameIndex, int keypointId,
+					KeypointState previousState);
+
+	private:
+		static const int NumStates = 4;
+		static AnnotationCount toAnnotationCount(const int *counts);
+		void countState(int imgSetIndex, int frameIndex, int keypointId,
+					uint8_t state, int delta);
+		void buildIdTable();
+
+		int m_numImgSets = 0;
+		int m_numCameras;
+		int m_numKeypoints;
+		std::vector<float> m_x;
+		std::vector<float> m_y;
+		std::vector<uint8_t> m_state;
+		std::vector<int> m_frameCounts;				//[imgSet][camera][state]
+		std::vector<int> m_imgSetCounts;			//[imgSet][state]
+		std::vector<int> m_keypointCounts;		//[camera][keypointId][state]
+		int m_totalCounts[NumStates] = {0, 0, 0, 0};
+		QList<QString> m_entities;
+		QList<QString> m_bodyparts;
+		QList<QString> m_IDs;
+		QList<QColor> m_colors;
+		QHash<QString, int> m_idMap;
+		QList<QString> m_entityNames;
+		QList<QString> m_bodypartNames;
+		std::vector<int> m_entityIndices;
+		std::vector<int> m_bodypartIndices;
+		std::vector<int> m_idTable;						//[entityIndex][bodypartIndex]
+};
+
+#endif
@@ -0,0 +1,170 @@
+/*******************************************************************************
+ * File:			  profiler.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "profiler.hpp"
+
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <cmath>
+
+
+Profiler::Profiler() {
+	m_clock.start();
+}
+
+
+Profiler *Profiler::instance() {
+	static Profiler profiler;
+	return &profiler;
+}
+
+
+int Profiler::stage(const char *name) {
+	Profiler *profiler = instance();
+	QMutexLocker locker(&profiler->m_stageMutex);
+	QString stageName = QString::fromUtf8(name);
+	int index = profiler->m_stageNames.indexOf(stageName);
+	if (index == -1) {
+		index = profiler->m_stageNames.size();
+		profiler->m_stageNames.append(stageName);
+	}
+	return index;
+}
+
+
+QString Profiler::stageName(int stage) const {
+	QMutexLocker locker(&m_stageMutex);
+	return m_stageNames.value(stage);
+}
+
+
+void Profiler::record(int stage, qint64 start, qint64 duration) {
+	const quint64 index = m_writeIndex.fetch_add(1, std::memory_order_relaxed);
+	Slot& slot = m_slots[index%Capacity];
+	slot.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.stage.store(stage, std::memory_order_relaxed);
+	slot.start.store(start, std::memory_order_relaxed);
+	slot.duration.store(duration, std::memory_order_relaxed);
+	slot.thread.store(reinterpret_cast<quintptr>(QThread::currentThreadId()),
+				std::memory_order_relaxed);
+	slot.sequence.store(index+1, std::memory_order_release);
+}
+
+
+QList<Profiler::Sample> Profiler::samples() const {
+	QList<Sample> samples;
+	samples.reserve(Capacity);
+	for (const auto& slot : m_slots) {
+		quint64 sequence = slot.sequence.load(std::memory_order_acquire);
+		if (sequence == 0) continue;
+		Sample sample;
+		sample.stage = slot.stage.load(std::memory_order_relaxed);
+		sample.start = slot.start.load(std::memory_order_relaxed);
+		sample.duration = slot.duration.load(std::memory_order_relaxed);
+		sample.thread = slot.thread.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) != sequence) continue;
+		samples.append(sample);
+	}
+	std::sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b) {
+				return a.start < b.start;});
+	return samples;
+}
+
+
+QList<Profiler::StageStatistics> Profiler::statistics(int lastSamples) const {
+	QList<QList<qint64>> durations;
+	for (const auto& sample : samples()) {
+		if (sample.stage >= durations.size()) durations.resize(sample.stage+1);
+		durations[sample.stage].append(sample.duration);
+	}
+	QList<StageStatistics> statistics;
+	for (int stage = 0; stage < durations.size(); stage++) {
+		QList<qint64>& stageDurations = durations[stage];
+		if (stageDurations.isEmpty()) continue;
+		//Samples are in chronological order, only the newest ones are kept
+		if (lastSamples > 0 && stageDurations.size() > lastSamples) {
+			stageDurations.remove(0, stageDurations.size() - lastSamples);
+		}
+		std::sort(stageDurations.begin(), stageDurations.end());
+		auto percentile = [&stageDurations](double p) {
+			int rank = static_cast<int>(std::ceil(p*stageDurations.size())) - 1;
+			return stageDurations[std::max(0, rank)]/1e6;
+		};
+		StageStatistics stageStatistics;
+		stageStatistics.name = stageName(stage);
+		stageStatistics.count = stageDurations.size();
+		stageStatistics.p50 = percentile(0.5);
+		stageStatistics.p95 = percentile(0.95);
+		stageStatistics.max = stageDurations.last()/1e6;
+		statistics.append(stageStatistics);
+	}
+	return statistics;
+}
+
+
+void Profiler::clear() {
+	for (auto& slot : m_slots) {
+		slot.sequence.store(0, std::memory_order_relaxed);
+	}
+}
+
+
+bool Profiler::exportCSV(const QString& path) const {
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+		std::cout << "Could not open " << path.toStdString() << std::endl;
+		return false;
+	}
+	QTextStream stream(&file);
+	stream << "stage,thread,start_ms,duration_ms\n";
+	for (const auto& sample : samples()) {
+		stream << stageName(sample.stage) << "," << sample.thread << ","
+					 << QString::number(sample.start/1e6, 'f', 3) << ","
+					 << QString::number(sample.duration/1e6, 'f', 3) << "\n";
+	}
+	return stream.status() == QTextStream::Ok;
+}
+
+
+bool Profiler::exportChromeTrace(const QString& path) const {
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly)) {
+		std::cout << "Could not open " << path.toStdString() << std::endl;
+		return false;
+	}
+	//Complete events of the Trace Event Format, loadable in chrome://tracing
+	QJsonArray events;
+	QHash<quint64, int> threadIds;
+	for (const auto& sample : samples()) {
+		if (!threadIds.contains(sample.thread)) {
+			threadIds.insert(sample.thread, threadIds.size()+1);
+		}
+		QJsonObject event;
+		event["name"] = stageName(sample.stage);
+		event["ph"] = "X";
+		event["ts"] = sample.start/1e3;
+		event["dur"] = sample.duration/1e3;
+		event["pid"] = 1;
+		event["tid"] = threadIds[sample.thread];
+		events.append(event);
+	}
+	QJsonObject trace;
+	trace["traceEvents"] = events;
+	trace["displayTimeUnit"] = "ms";
+	return file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) > 0;
+}
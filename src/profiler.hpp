@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * File:			  profiler.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "globals.hpp"
+
+#include <QElapsedTimer>
+#include <QMutex>
+
+#include <atomic>
+
+
+// Latency samples of the editor's hot paths. ScopedTimer records the time
+// spent in a scope into a fixed size ring buffer, writers only do an atomic
+// increment and never block, so timers can be placed on any thread. Readers
+// take a consistent copy of the samples that are currently in the buffer,
+// a slot that is overwritten while it is copied is skipped.
+//
+//   void ImageViewer::setFrame(...) {
+//     PROFILE_SCOPE("Navigation");
+//     ...
+class Profiler {
+	public:
+		static const int Capacity = 8192;
+
+		struct Sample {
+			int stage;
+			qint64 start;					//ns since the profiler was created
+			qint64 duration;			//ns
+			quint64 thread;
+		};
+
+		struct StageStatistics {
+			QString name;
+			int count = 0;
+			double p50 = 0.0;			//ms
+			double p95 = 0.0;
+			double max = 0.0;
+		};
+
+		static Profiler *instance();
+		static int stage(const char *name);
+
+		qint64 now() const {return m_clock.nsecsElapsed();}
+		void record(int stage, qint64 start, qint64 duration);
+		QList<Sample> samples() const;
+		QList<StageStatistics> statistics(int lastSamples = 0) const;
+		QString stageName(int stage) const;
+		void clear();
+
+		bool exportCSV(const QString& path) const;
+		bool exportChromeTrace(const QString& path) const;
+
+	private:
+		Profiler();
+
+		struct Slot {
+			std::atomic<quint64> sequence{0};		//0 while empty or being written
+			std::atomic<int> stage{0};
+			std::atomic<qint64> start{0};
+			std::atomic<qint64> duration{0};
+			std::atomic<quint64> thread{0};
+		};
+
+		QElapsedTimer m_clock;
+		Slot m_slots[Capacity];
+		std::atomic<quint64> m_writeIndex{0};
+		mutable QMutex m_stageMutex;
+		QList<QString> m_stageNames;
+};
+
+
+class ScopedTimer {
+	public:
+		explicit ScopedTimer(int stage) : m_stage(stage),
+					m_start(Profiler::instance()->now()) {}
+		~ScopedTimer() {
+			Profiler *profiler = Profiler::instance();
+			profiler->record(m_stage, m_start, profiler->now() - m_start);
+		}
+
+	private:
+		int m_stage;
+		qint64 m_start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) \
+	static const int PROFILE_CONCAT(profileStage_, __LINE__) = Profiler::stage(name); \
+	ScopedTimer PROFILE_CONCAT(profileTimer_, __LINE__)(PROFILE_CONCAT(profileStage_, __LINE__))
+
+#endif
@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * File:			  reprojectionjob.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "reprojectionjob.hpp"
+#include "profiler.hpp"
+
+#include <QThread>
+
+#include <algorithm>
+
+
+ReprojectionJob::ReprojectionJob(const ReprojectionTool *reprojectionTool,
+			std::vector<SetBuffer> sets, double outlierThreshold, QObject *parent) :
+			QObject(parent), m_reprojectionTool(reprojectionTool),
+			m_sets(std::move(sets)), m_outlierThreshold(outlierThreshold) {
+	m_threadPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount()-1));
+}
+
+
+ReprojectionJob::~ReprojectionJob() {
+	cancel();
+}
+
+
+void ReprojectionJob::start() {
+	const int numWorkers = std::min<int>(m_threadPool.maxThreadCount(), m_sets.size());
+	for (int i = 0; i < numWorkers; i++) {
+		m_threadPool.start([this]() {work();});
+	}
+}
+
+
+void ReprojectionJob::cancel() {
+	m_cancelled = true;
+	m_threadPool.waitForDone();
+}
+
+
+void ReprojectionJob::work() {
+	const int numSets = m_sets.size();
+	int index;
+	while (!m_cancelled && (index = m_nextSet++) < numSets) {
+		PROFILE_SCOPE("Reprojection (background)");
+		SetBuffer& set = m_sets[index];
+		if (m_outlierThreshold > 0.0) {
+			cv::Mat inliers;
+			m_reprojectionTool->reconstructPoints3DRobust(set.points, set.valid,
+						m_outlierThreshold, set.points3D, set.reconstructed, inliers);
+		}
+		else {
+			m_reprojectionTool->reconstructPoints3D(set.points, set.valid, set.points3D,
+						set.reconstructed);
+		}
+		m_reprojectionTool->projectPoints(set.points3D, set.projected);
+		bool notify;
+		{
+			QMutexLocker locker(&m_finishedMutex);
+			notify = m_finished.isEmpty();
+			m_finished.append(index);
+		}
+		//One queued signal per batch, the receiver takes everything finished
+		if (notify) emit setsFinished();
+	}
+}
+
+
+QList<const ReprojectionJob::SetBuffer*> ReprojectionJob::takeFinished(int maxSets) {
+	QMutexLocker locker(&m_finishedMutex);
+	QList<const SetBuffer*> sets;
+	const int numSets = std::min<int>(maxSets, m_finished.size());
+	for (int i = 0; i < numSets; i++) sets.append(&m_sets[m_finished[i]]);
+	m_finished.remove(0, numSets);
+	m_numTaken += numSets;
+	return sets;
+}
@@ -0,0 +1,74 @@
+/*******************************************************************************
+ * File:			  reprojectionjob.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef REPROJECTIONJOB_H
+#define REPROJECTIONJOB_H
+
+#include "globals.hpp"
+#include "reprojectiontool.hpp"
+
+#include <QMutex>
+#include <QThreadPool>
+
+#include <atomic>
+#include <vector>
+
+
+// Triangulates and reprojects the keypoints of many frame sets in the
+// background. The input of every set is gathered on the GUI thread before
+// the job starts, so the workers never touch the dataset. Workers pull the
+// next set from a shared counter, sets are processed in the given order.
+// Finished sets are handed back with takeFinished(), setsFinished() is
+// emitted whenever new ones become available.
+class ReprojectionJob : public QObject {
+	Q_OBJECT
+	public:
+		struct SetBuffer {
+			int imgSetIndex;
+			cv::Mat points;					//numKeypoints x numCameras CV_64FC2
+			cv::Mat valid;					//numKeypoints x numCameras CV_8U
+			cv::Mat points3D;
+			cv::Mat reconstructed;
+			cv::Mat projected;
+		};
+
+		//outlierThreshold > 0 selects the robust triangulation
+		ReprojectionJob(const ReprojectionTool *reprojectionTool,
+					std::vector<SetBuffer> sets, double outlierThreshold,
+					QObject *parent = nullptr);
+		~ReprojectionJob();
+
+		void start();
+		//Blocks until the running workers returned, at most one set each
+		void cancel();
+		bool isCancelled() const {return m_cancelled;}
+		int numSets() const {return m_sets.size();}
+		int numTaken() const {return m_numTaken;}
+		bool isDone() const {return m_numTaken == static_cast<int>(m_sets.size());}
+		//Pointers stay valid as long as the job exists
+		QList<const SetBuffer*> takeFinished(int maxSets);
+
+	signals:
+		void setsFinished();
+
+	private:
+		void work();
+
+		const ReprojectionTool *m_reprojectionTool;
+		std::vector<SetBuffer> m_sets;
+		double m_outlierThreshold;
+		QThreadPool m_threadPool;
+		std::atomic<int> m_nextSet{0};
+		std::atomic<bool> m_cancelled{false};
+		QMutex m_finishedMutex;
+		QList<int> m_finished;
+		int m_numTaken = 0;
+};
+
+#endif
@@ -9,6 +9,13 @@
 
 #include "reprojectiontool.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
 
 ReprojectionTool::ReprojectionTool(QList<QString> intrinsicsPaths,
 			QList<QString> extrinsicsPaths, int primaryIndex) :
@@ -21,6 +28,7 @@ ReprojectionTool::ReprojectionTool(QList<QString> intrinsicsPaths,
 		CameraExtrinsics cameraExtrinsics;
 		readExtrinsincs(path, cameraExtrinsics);
 		m_cameraExtrinsicsList.append(cameraExtrinsics);
+		m_cameraModels.append(cameraModel(cameraIntrinics, cameraExtrinsics));
 	}
 }
 
@@ -44,61 +52,411 @@ void ReprojectionTool::readExtrinsincs(const QString& path,
 }
 
 
-cv::Mat ReprojectionTool::reconstructPoint3D(QList<QPointF> points,
-			QList<int> camerasToUse) {
-	QList<cv::Mat> camMats;
-	QList<cv::Mat> intrinsicMats;
-	QList<cv::Mat> distCoefficients;
-
-	for (const auto& cam : camerasToUse) {
-		cv::Mat camMat = (m_cameraExtrinsicsList[cam].locationMatrix *
-											m_cameraIntrinsicsList[cam].intrinsicMatrix).t();
-		camMats.append(camMat);
-		distCoefficients.append(m_cameraIntrinsicsList[cam].distortionCoefficients);
-		intrinsicMats.append(m_cameraIntrinsicsList[cam].intrinsicMatrix);
+//The calibration files store the transposed intrinsic and rotation matrices
+ReprojectionTool::CameraModel ReprojectionTool::cameraModel(
+			const CameraIntrinics& cameraIntrinics,
+			const CameraExtrinsics& cameraExtrinsics) {
+	CameraModel camera;
+	cv::Mat projectionMatrix = (cameraExtrinsics.locationMatrix *
+				cameraIntrinics.intrinsicMatrix).t();
+	camera.projectionMatrix = projectionMatrix;
+	cv::Mat rotation = cameraExtrinsics.rotationMatrix.t();
+	camera.rotation = rotation;
+	const double *translation = cameraExtrinsics.translationVector.ptr<double>();
+	camera.translation = cv::Vec3d(translation[0], translation[1], translation[2]);
+	const cv::Mat& K = cameraIntrinics.intrinsicMatrix;
+	camera.fx = K.at<double>(0,0);
+	camera.fy = K.at<double>(1,1);
+	camera.cx = K.at<double>(2,0);
+	camera.cy = K.at<double>(2,1);
+
+	const cv::Mat& distortion = cameraIntrinics.distortionCoefficients;
+	const int numCoefficients = distortion.total();
+	const double *coefficients = distortion.empty() ? nullptr : distortion.ptr<double>();
+	for (int i = 0; i < 12; i++) {
+		camera.distortion[i] = i < numCoefficients ? coefficients[i] : 0.0;
+	}
+	if (numCoefficients > 12) {
+		std::cout << "Tilted sensor distortion coefficients are ignored" << std::endl;
 	}
-	cv::Mat A = cv::Mat::zeros(points.size()*2,4, CV_64F);
+	return camera;
+}
 
+
+cv::Mat ReprojectionTool::reconstructPoint3D(QList<QPointF> points,
+			QList<int> camerasToUse) {
+	const int numCameras = m_cameraIntrinsicsList.size();
+	cv::Mat batchPoints(1, numCameras, CV_64FC2, cv::Scalar(0.0, 0.0));
+	cv::Mat valid = cv::Mat::zeros(1, numCameras, CV_8U);
 	for (int i = 0; i < points.size(); i++) {
-		cv::Mat point = cv::Mat({points[i].x(),points[i].y()});
-		cv::Mat undistPoint;
-		cv::undistortPoints(point, undistPoint, intrinsicMats[i].t(),
-					distCoefficients[i]);
-		undistPoint.at<double>(0) = undistPoint.at<double>(0) *
-					intrinsicMats[i].at<double>(0,0) +
-					intrinsicMats[i].at<double>(2,0);
-		undistPoint.at<double>(1) = undistPoint.at<double>(1) *
-					intrinsicMats[i].at<double>(1,1) +
-					intrinsicMats[i].at<double>(2,1);
-		undistPoint = cv::Mat({undistPoint.at<double>(0),
-	 				undistPoint.at<double>(1)});
-
-		A(cv::Range(2*i, 2*i+2), cv::Range::all()) = undistPoint *
-	 				camMats[i](cv::Range(2,3),
-	 				cv::Range::all()) -
-	 				camMats[i](cv::Range(0, 2),
-	 				cv::Range::all());
+		batchPoints.at<cv::Vec2d>(0, camerasToUse[i]) = cv::Vec2d(points[i].x(), points[i].y());
+		valid.at<uchar>(0, camerasToUse[i]) = 1;
 	}
-	cv::Mat w, u, vt;
-	cv::SVD::compute(A, w, u, vt);
-	cv::Mat X =  vt.t().col(3);
-	X = X/X.at<double>(0,12);
-	X = X(cv::Range(0,3), cv::Range::all());
+	cv::Mat points3D, reconstructed;
+	reconstructPoints3D(batchPoints, valid, points3D, reconstructed);
+	cv::Mat X = points3D.row(0).t();
 	return X;
 }
 
 
+//Eigenvector of the smallest eigenvalue of the symmetric matrix A, cyclic
+//Jacobi rotations on the stack. A is destroyed.
+static void smallestEigenvector(double A[4][4], double x[4]) {
+	double V[4][4] = {{1,0,0,0}, {0,1,0,0}, {0,0,1,0}, {0,0,0,1}};
+	for (int sweep = 0; sweep < 16; sweep++) {
+		double offDiagonal = 0.0, diagonal = 0.0;
+		for (int p = 0; p < 4; p++) {
+			diagonal += A[p][p]*A[p][p];
+			for (int q = p+1; q < 4; q++) offDiagonal += A[p][q]*A[p][q];
+		}
+		if (offDiagonal <= 1e-30*diagonal) break;
+		for (int p = 0; p < 3; p++) {
+			for (int q = p+1; q < 4; q++) {
+				if (A[p][q] == 0.0) continue;
+				double theta = (A[q][q] - A[p][p])/(2.0*A[p][q]);
+				double t = (theta >= 0.0 ? 1.0 : -1.0)/(std::abs(theta) +
+							std::sqrt(theta*theta + 1.0));
+				double c = 1.0/std::sqrt(t*t + 1.0);
+				double s = t*c;
+				for (int k = 0; k < 4; k++) {
+					double akp = A[k][p], akq = A[k][q];
+					A[k][p] = c*akp - s*akq;
+					A[k][q] = s*akp + c*akq;
+				}
+				for (int k = 0; k < 4; k++) {
+					double apk = A[p][k], aqk = A[q][k];
+					A[p][k] = c*apk - s*aqk;
+					A[q][k] = s*apk + c*aqk;
+				}
+				for (int k = 0; k < 4; k++) {
+					double vkp = V[k][p], vkq = V[k][q];
+					V[k][p] = c*vkp - s*vkq;
+					V[k][q] = s*vkp + c*vkq;
+				}
+			}
+		}
+	}
+	int smallest = 0;
+	for (int i = 1; i < 4; i++) {
+		if (A[i][i] < A[smallest][smallest]) smallest = i;
+	}
+	for (int k = 0; k < 4; k++) x[k] = V[k][smallest];
+}
+
+
+//Solves the DLT through its 4x4 normal equations A^T A, which have the
+//same null vector as A. Points are undistorted pixel coordinates.
+bool ReprojectionTool::triangulate(const int *cameras,
+			const cv::Point2d *undistortedPoints, int numViews, cv::Vec3d& point3D) const {
+	if (numViews < 2) return false;
+	double AtA[4][4] = {};
+	for (int view = 0; view < numViews; view++) {
+		const cv::Matx34d& P = m_cameraModels[cameras[view]].projectionMatrix;
+		const cv::Point2d& point = undistortedPoints[view];
+		double rows[2][4];
+		for (int k = 0; k < 4; k++) {
+			rows[0][k] = point.x*P(2,k) - P(0,k);
+			rows[1][k] = point.y*P(2,k) - P(1,k);
+		}
+		for (int r = 0; r < 2; r++) {
+			for (int k = 0; k < 4; k++) {
+				for (int l = k; l < 4; l++) AtA[k][l] += rows[r][k]*rows[r][l];
+			}
+		}
+	}
+	for (int k = 0; k < 4; k++) {
+		for (int l = 0; l < k; l++) AtA[k][l] = AtA[l][k];
+	}
+	double x[4];
+	smallestEigenvector(AtA, x);
+	if (x[3] == 0.0) return false;
+	point3D = cv::Vec3d(x[0]/x[3], x[1]/x[3], x[2]/x[3]);
+	return true;
+}
+
+
+//Projection as in projectPoint together with its derivative with respect to
+//the 3D point, chained through the distortion model
+cv::Point2d ReprojectionTool::projectPoint(int cam, const cv::Vec3d& point3D,
+			cv::Matx23d& jacobian) const {
+	const CameraModel& camera = m_cameraModels[cam];
+	const double *d = camera.distortion;
+	cv::Vec3d p = camera.rotation*point3D + camera.translation;
+	double z = p[2] != 0.0 ? 1.0/p[2] : 1.0;
+	double x = p[0]*z, y = p[1]*z;
+	double r2 = x*x + y*y;
+	double r4 = r2*r2;
+	double r6 = r4*r2;
+	double numerator = 1.0 + d[0]*r2 + d[1]*r4 + d[4]*r6;
+	double denominator = 1.0 + d[5]*r2 + d[6]*r4 + d[7]*r6;
+	double radial = numerator/denominator;
+	double dRadial = ((d[0] + 2.0*d[1]*r2 + 3.0*d[4]*r4)*denominator -
+				numerator*(d[5] + 2.0*d[6]*r2 + 3.0*d[7]*r4))/(denominator*denominator);
+	double xd = x*radial + 2.0*d[2]*x*y + d[3]*(r2 + 2.0*x*x) + d[8]*r2 + d[9]*r4;
+	double yd = y*radial + d[2]*(r2 + 2.0*y*y) + 2.0*d[3]*x*y + d[10]*r2 + d[11]*r4;
+
+	//d(xd,yd)/d(x,y)
+	double prismX = d[8] + 2.0*d[9]*r2;
+	double prismY = d[10] + 2.0*d[11]*r2;
+	cv::Matx22d distortionJacobian(
+				radial + 2.0*x*x*dRadial + 2.0*d[2]*y + 6.0*d[3]*x + 2.0*x*prismX,
+				2.0*x*y*dRadial + 2.0*d[2]*x + 2.0*d[3]*y + 2.0*y*prismX,
+				2.0*x*y*dRadial + 2.0*d[2]*x + 2.0*d[3]*y + 2.0*x*prismY,
+				radial + 2.0*y*y*dRadial + 6.0*d[2]*y + 2.0*d[3]*x + 2.0*y*prismY);
+	//d(x,y)/dp, dp/dX is the rotation
+	cv::Matx23d perspectiveJacobian(z, 0.0, -x*z,
+				0.0, z, -y*z);
+	cv::Matx22d focal(camera.fx, 0.0, 0.0, camera.fy);
+	jacobian = focal*distortionJacobian*perspectiveJacobian*camera.rotation;
+	return cv::Point2d(camera.fx*xd + camera.cx, camera.fy*yd + camera.cy);
+}
+
+
+//Levenberg-Marquardt on the three coordinates, warm started from the DLT.
+//The damping adapts per step, a step that does not lower the squared pixel
+//error is retried with stronger damping.
+void ReprojectionTool::refinePoint(const int *cameras,
+			const cv::Point2d *observedPoints, int numViews, cv::Vec3d& point3D) const {
+	if (numViews < 2) return;
+	auto cost = [&](const cv::Vec3d& X) {
+		double sum = 0.0;
+		for (int view = 0; view < numViews; view++) {
+			cv::Point2d delta = projectPoint(cameras[view], X) - observedPoints[view];
+			sum += delta.x*delta.x + delta.y*delta.y;
+		}
+		return sum;
+	};
+	double lambda = 1e-3;
+	for (int iteration = 0; iteration < RefinementIterations; iteration++) {
+		cv::Matx33d JtJ = cv::Matx33d::zeros();
+		cv::Matx31d Jtr = cv::Matx31d::zeros();
+		double currentCost = 0.0;
+		for (int view = 0; view < numViews; view++) {
+			cv::Matx23d J;
+			cv::Point2d projected = projectPoint(cameras[view], point3D, J);
+			cv::Matx21d r(projected.x - observedPoints[view].x,
+						projected.y - observedPoints[view].y);
+			JtJ += J.t()*J;
+			Jtr += J.t()*r;
+			currentCost += r(0)*r(0) + r(1)*r(1);
+		}
+		bool improved = false;
+		for (int attempt = 0; attempt < 4 && !improved; attempt++) {
+			cv::Matx33d A = JtJ;
+			for (int k = 0; k < 3; k++) A(k,k) += lambda*JtJ(k,k) + 1e-12;
+			cv::Matx31d delta = A.solve(-Jtr, cv::DECOMP_CHOLESKY);
+			cv::Vec3d candidate(point3D[0] + delta(0), point3D[1] + delta(1),
+						point3D[2] + delta(2));
+			if (cost(candidate) < currentCost) {
+				point3D = candidate;
+				lambda = std::max(lambda*0.1, 1e-9);
+				improved = true;
+				if (cv::norm(delta) < 1e-9*(cv::norm(point3D) + 1.0)) return;
+			}
+			else {
+				lambda *= 10.0;
+			}
+		}
+		if (!improved) return;
+	}
+}
+
+
+void ReprojectionTool::reconstructPoints3D(const cv::Mat& points,
+			const cv::Mat& valid, cv::Mat& points3D, cv::Mat& reconstructed) const {
+	const int numPoints = points.rows;
+	const int numCameras = points.cols;
+	points3D.create(numPoints, 3, CV_64F);
+	reconstructed.create(numPoints, 1, CV_8U);
+	std::vector<int> cameras(numCameras);
+	std::vector<cv::Point2d> observedPoints(numCameras);
+	std::vector<cv::Point2d> undistortedPoints(numCameras);
+	for (int i = 0; i < numPoints; i++) {
+		const uchar *validRow = valid.ptr<uchar>(i);
+		const cv::Vec2d *pointsRow = points.ptr<cv::Vec2d>(i);
+		int numViews = 0;
+		for (int cam = 0; cam < numCameras; cam++) {
+			if (!validRow[cam]) continue;
+			cameras[numViews] = cam;
+			observedPoints[numViews] = cv::Point2d(pointsRow[cam][0], pointsRow[cam][1]);
+			undistortedPoints[numViews] = undistortPoint(cam, observedPoints[numViews]);
+			numViews++;
+		}
+		cv::Vec3d X(0.0, 0.0, 0.0);
+		bool success = triangulate(cameras.data(), undistortedPoints.data(),
+					numViews, X);
+		if (success) refinePoint(cameras.data(), observedPoints.data(), numViews, X);
+		reconstructed.at<uchar>(i) = success;
+		double *row = points3D.ptr<double>(i);
+		row[0] = X[0];
+		row[1] = X[1];
+		row[2] = X[2];
+	}
+}
+
+
+//Every pair of views is a minimal hypothesis. Hypotheses are scored with the
+//truncated squared reprojection error over all views (MSAC), which prefers
+//the hypothesis that explains most views and explains them best. If there
+//are more pairs than MaxHypotheses a fixed pseudo random subset is tried.
+void ReprojectionTool::reconstructPoints3DRobust(const cv::Mat& points,
+			const cv::Mat& valid, double outlierThreshold, cv::Mat& points3D,
+			cv::Mat& reconstructed, cv::Mat& inliers) const {
+	const int numPoints = points.rows;
+	const int numCameras = points.cols;
+	points3D.create(numPoints, 3, CV_64F);
+	reconstructed.create(numPoints, 1, CV_8U);
+	valid.copyTo(inliers);
+	const double threshold2 = outlierThreshold*outlierThreshold;
+	std::vector<int> cameras(numCameras);
+	std::vector<cv::Point2d> observedPoints(numCameras);
+	std::vector<cv::Point2d> undistortedPoints(numCameras);
+	std::vector<double> errors(numCameras);
+	std::vector<uchar> inlierViews(numCameras), bestInlierViews(numCameras);
+	std::vector<int> subsetCameras(numCameras);
+	std::vector<cv::Point2d> subsetPoints(numCameras);
+
+	//Squared reprojection errors of X in all views, returns the MSAC score
+	auto score = [&](int numViews, const cv::Vec3d& X, uchar *inlierMask,
+				int *numInliers) {
+		double cost = 0.0;
+		*numInliers = 0;
+		for (int view = 0; view < numViews; view++) {
+			cv::Point2d delta = projectPoint(cameras[view], X) - observedPoints[view];
+			errors[view] = delta.x*delta.x + delta.y*delta.y;
+			inlierMask[view] = errors[view] < threshold2;
+			*numInliers += inlierMask[view];
+			cost += std::min(errors[view], threshold2);
+		}
+		return cost;
+	};
+	auto triangulateSubset = [&](int numViews, const uchar *mask, cv::Vec3d& X) {
+		int numSubset = 0;
+		for (int view = 0; view < numViews; view++) {
+			if (!mask[view]) continue;
+			subsetCameras[numSubset] = cameras[view];
+			subsetPoints[numSubset] = undistortedPoints[view];
+			numSubset++;
+		}
+		return triangulate(subsetCameras.data(), subsetPoints.data(), numSubset, X);
+	};
+
+	for (int i = 0; i < numPoints; i++) {
+		const uchar *validRow = valid.ptr<uchar>(i);
+		const cv::Vec2d *pointsRow = points.ptr<cv::Vec2d>(i);
+		int numViews = 0;
+		for (int cam = 0; cam < numCameras; cam++) {
+			if (!validRow[cam]) continue;
+			cameras[numViews] = cam;
+			observedPoints[numViews] = cv::Point2d(pointsRow[cam][0], pointsRow[cam][1]);
+			undistortedPoints[numViews] = undistortPoint(cam, observedPoints[numViews]);
+			numViews++;
+		}
+		cv::Vec3d X(0.0, 0.0, 0.0);
+		bool success = triangulate(cameras.data(), undistortedPoints.data(), numViews, X);
+		//With two views there is nothing to vote on
+		if (success && numViews > 2) {
+			const int numPairs = numViews*(numViews-1)/2;
+			std::minstd_rand generator(i + 1);
+			double bestCost = std::numeric_limits<double>::max();
+			int bestNumInliers = 0;
+			for (int hypothesis = 0; hypothesis < std::min(numPairs, MaxHypotheses);
+						hypothesis++) {
+				int a, b;
+				if (numPairs <= MaxHypotheses) {
+					//Enumerates the pairs (a,b), a < b, by their index
+					a = 0;
+					int index = hypothesis;
+					while (index >= numViews-1-a) {
+						index -= numViews-1-a;
+						a++;
+					}
+					b = a + 1 + index;
+				}
+				else {
+					a = generator()%numViews;
+					b = (a + 1 + generator()%(numViews-1))%numViews;
+				}
+				int pair[2] = {cameras[a], cameras[b]};
+				cv::Point2d pairPoints[2] = {undistortedPoints[a], undistortedPoints[b]};
+				cv::Vec3d hypothesisX;
+				if (!triangulate(pair, pairPoints, 2, hypothesisX)) continue;
+				int numInliers;
+				double cost = score(numViews, hypothesisX, inlierViews.data(), &numInliers);
+				if (cost < bestCost) {
+					bestCost = cost;
+					bestNumInliers = numInliers;
+					bestInlierViews.swap(inlierViews);
+				}
+				if (numInliers == numViews) break;
+			}
+			//Consensus refinement: DLT over the inliers, then once more over
+			//the views that agree with the refined point
+			if (bestNumInliers >= 2 && bestNumInliers < numViews) {
+				cv::Vec3d refinedX;
+				if (triangulateSubset(numViews, bestInlierViews.data(), refinedX)) {
+					int numInliers;
+					score(numViews, refinedX, inlierViews.data(), &numInliers);
+					cv::Vec3d consensusX;
+					if (numInliers >= 2 && triangulateSubset(numViews, inlierViews.data(),
+								consensusX)) {
+						X = consensusX;
+						bestInlierViews.swap(inlierViews);
+					}
+					else {
+						X = refinedX;
+					}
+					uchar *inlierRow = inliers.ptr<uchar>(i);
+					for (int view = 0; view < numViews; view++) {
+						inlierRow[cameras[view]] = bestInlierViews[view];
+					}
+				}
+			}
+		}
+		if (success) {
+			//Refine on the views the point was finally triangulated from
+			const uchar *inlierRow = inliers.ptr<uchar>(i);
+			int numSubset = 0;
+			for (int view = 0; view < numViews; view++) {
+				if (!inlierRow[cameras[view]]) continue;
+				subsetCameras[numSubset] = cameras[view];
+				subsetPoints[numSubset] = observedPoints[view];
+				numSubset++;
+			}
+			refinePoint(subsetCameras.data(), subsetPoints.data(), numSubset, X);
+		}
+		reconstructed.at<uchar>(i) = success;
+		double *row = points3D.ptr<double>(i);
+		row[0] = X[0];
+		row[1] = X[1];
+		row[2] = X[2];
+	}
+}
+
+
 QList<QPointF> ReprojectionTool::reprojectPoint(cv::Mat point3D) {
-	cv::Mat R,res;
+	const double *X = point3D.ptr<double>();
+	const cv::Vec3d point(X[0], X[1], X[2]);
 	QList<QPointF> reprojectedPoints;
-	for (int cam = 0; cam < m_cameraIntrinsicsList.size(); cam ++) {
-		cv::Rodrigues(m_cameraExtrinsicsList[cam].rotationMatrix.t(), R);
-		cv::Mat test;
-		cv::projectPoints(point3D, R,
-					m_cameraExtrinsicsList[cam].translationVector,
-					m_cameraIntrinsicsList[cam].intrinsicMatrix.t(),
-					m_cameraIntrinsicsList[cam].distortionCoefficients, res);
-		reprojectedPoints.append(QPointF(res.at<double>(0,0), res.at<double>(0,1)));
+	for (int cam = 0; cam < m_cameraModels.size(); cam ++) {
+		cv::Point2d projected = projectPoint(cam, point);
+		reprojectedPoints.append(QPointF(projected.x, projected.y));
 	}
 	return reprojectedPoints;
 }
+
+
+void ReprojectionTool::projectPoints(const cv::Mat& points3D,
+			cv::Mat& projected) const {
+	const int numCameras = m_cameraModels.size();
+	projected.create(points3D.rows, numCameras, CV_64FC2);
+	for (int i = 0; i < points3D.rows; i++) {
+		const double *X = points3D.ptr<double>(i);
+		const cv::Vec3d point(X[0], X[1], X[2]);
+		cv::Vec2d *row = projected.ptr<cv::Vec2d>(i);
+		for (int cam = 0; cam < numCameras; cam++) {
+			cv::Point2d p = projectPoint(cam, point);
+			row[cam] = cv::Vec2d(p.x, p.y);
+		}
+	}
+}
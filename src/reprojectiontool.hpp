@@ -32,10 +32,42 @@ class ReprojectionTool : public QObject {
 			cv::Mat essentialMatrix;
 			cv::Mat fundamentalMatrix;
 		} CameraExtrinsics;
+
+		//Everything needed to map between pixels and 3D, derived once from the
+		//calibration files. Distortion follows OpenCV's model with up to 12
+		//coefficients (k1 k2 p1 p2 k3 k4 k5 k6 s1 s2 s3 s4), missing ones are 0.
+		struct CameraModel {
+			cv::Matx34d projectionMatrix;		//K [R|t]
+			cv::Matx33d rotation;						//world to camera
+			cv::Vec3d translation;
+			double fx, fy, cx, cy;
+			double distortion[12];
+		};
+
+		static const int MaxHypotheses = 64;
+		static const int RefinementIterations = 5;
+
 		explicit ReprojectionTool(QList<QString> intrinsicsPaths,
 					QList<QString> extrinsicsPaths, int primaryIndex);
 		cv::Mat reconstructPoint3D(QList<QPointF> points, QList<int> camerasToUse);
+		//points: numPoints x numCameras CV_64FC2, valid: numPoints x numCameras CV_8U
+		//points3D: numPoints x 3 CV_64F, reconstructed: numPoints x 1 CV_8U, a point
+		//is reconstructed if it is valid in at least two cameras. The DLT result is
+		//refined to minimize the pixel reprojection error.
+		void reconstructPoints3D(const cv::Mat& points, const cv::Mat& valid,
+					cv::Mat& points3D, cv::Mat& reconstructed) const;
+		//Like reconstructPoints3D, but views that disagree with the consensus of
+		//the others by more than outlierThreshold pixels are left out. inliers
+		//(numPoints x numCameras CV_8U) flags the valid views that were used.
+		void reconstructPoints3DRobust(const cv::Mat& points, const cv::Mat& valid,
+					double outlierThreshold, cv::Mat& points3D, cv::Mat& reconstructed,
+					cv::Mat& inliers) const;
 		QList<QPointF> reprojectPoint(cv::Mat point3D);
+		//points3D: numPoints x 3 CV_64F, projected: numPoints x numCameras CV_64FC2
+		void projectPoints(const cv::Mat& points3D, cv::Mat& projected) const;
+		inline cv::Point2d projectPoint(int cam, const cv::Vec3d& point3D) const;
+		inline cv::Point2d undistortPoint(int cam, const cv::Point2d& point) const;
+		const QList<CameraModel>& cameraModels() const {return m_cameraModels;}
 		QList<QString> cameraNames() {return m_cameraNames;};
 		QList<CameraExtrinsics> extrinsicsList() {return m_cameraExtrinsicsList;};
 		QList<CameraIntrinics> intrinsicsList() {return m_cameraIntrinsicsList;};
@@ -46,13 +78,68 @@ class ReprojectionTool : public QObject {
 
 		void readExtrinsincs(const QString& path,
 					CameraExtrinsics& cameraExtrinsics);
+		bool triangulate(const int *cameras, const cv::Point2d *undistortedPoints,
+					int numViews, cv::Vec3d& point3D) const;
+		void refinePoint(const int *cameras, const cv::Point2d *observedPoints,
+					int numViews, cv::Vec3d& point3D) const;
+		cv::Point2d projectPoint(int cam, const cv::Vec3d& point3D,
+					cv::Matx23d& jacobian) const;
+		static CameraModel cameraModel(const CameraIntrinics& cameraIntrinics,
+					const CameraExtrinsics& cameraExtrinsics);
 
 		QList<CameraIntrinics> m_cameraIntrinsicsList;
 		int m_primaryIndex;
 		QList<CameraExtrinsics> m_cameraExtrinsicsList;
+		QList<CameraModel> m_cameraModels;
 
 		QList<QString> m_cameraNames;
 
 };
 
+
+//Same arithmetic as cv::projectPoints
+inline cv::Point2d ReprojectionTool::projectPoint(int cam,
+			const cv::Vec3d& point3D) const {
+	const CameraModel& camera = m_cameraModels[cam];
+	const double *d = camera.distortion;
+	cv::Vec3d p = camera.rotation*point3D + camera.translation;
+	double z = p[2] != 0.0 ? 1.0/p[2] : 1.0;
+	double x = p[0]*z, y = p[1]*z;
+	double r2 = x*x + y*y;
+	double r4 = r2*r2;
+	double r6 = r4*r2;
+	double radial = (1.0 + d[0]*r2 + d[1]*r4 + d[4]*r6)/
+				(1.0 + d[5]*r2 + d[6]*r4 + d[7]*r6);
+	double xd = x*radial + 2.0*d[2]*x*y + d[3]*(r2 + 2.0*x*x) + d[8]*r2 + d[9]*r4;
+	double yd = y*radial + d[2]*(r2 + 2.0*y*y) + 2.0*d[3]*x*y + d[10]*r2 + d[11]*r4;
+	return cv::Point2d(camera.fx*xd + camera.cx, camera.fy*yd + camera.cy);
+}
+
+
+//Same fixed point iteration as cv::undistortPoints with its default five
+//iterations, the result is in pixels of the undistorted image
+inline cv::Point2d ReprojectionTool::undistortPoint(int cam,
+			const cv::Point2d& point) const {
+	const CameraModel& camera = m_cameraModels[cam];
+	const double *d = camera.distortion;
+	const double x0 = (point.x - camera.cx)/camera.fx;
+	const double y0 = (point.y - camera.cy)/camera.fy;
+	double x = x0, y = y0;
+	for (int i = 0; i < 5; i++) {
+		double r2 = x*x + y*y;
+		double icdist = (1.0 + ((d[7]*r2 + d[6])*r2 + d[5])*r2)/
+					(1.0 + ((d[4]*r2 + d[1])*r2 + d[0])*r2);
+		if (icdist < 0) {
+			x = x0;
+			y = y0;
+			break;
+		}
+		double deltaX = 2.0*d[2]*x*y + d[3]*(r2 + 2.0*x*x) + d[8]*r2 + d[9]*r2*r2;
+		double deltaY = d[2]*(r2 + 2.0*y*y) + 2.0*d[3]*x*y + d[10]*r2 + d[11]*r2*r2;
+		x = (x0 - deltaX)*icdist;
+		y = (y0 - deltaY)*icdist;
+	}
+	return cv::Point2d(x*camera.fx + camera.cx, y*camera.fy + camera.cy);
+}
+
 #endif
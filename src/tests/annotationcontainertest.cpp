@@ -0,0 +1,122 @@
+/*******************************************************************************
+ * File:			  annotationcontainertest.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "annotationcontainer.hpp"
+#include "testcsv.hpp"
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <cmath>
+
+
+//Large enough for the container to be written to disk
+static const int NumMappedRows = 6000;
+static const int NumKeypoints = 20;
+
+// Containers have to reproduce the csv they were imported from byte for byte,
+// both when they stay in memory and when they are written next to the csv.
+class AnnotationContainerTest : public QObject {
+	Q_OBJECT
+
+	private slots:
+		void roundTripInMemory();
+		void roundTripMapped();
+		void staleContainerIsReplaced();
+};
+
+
+void AnnotationContainerTest::roundTripInMemory() {
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	QByteArray csv = formatTestCsv(randomRows(50, NumKeypoints, 1));
+	QVERIFY(writeTestFile(AnnotationContainer::csvPath(dir.path()), csv));
+
+	AnnotationContainer container(dir.path());
+	QVERIFY(container.open(AnnotationContainer::ReadWrite));
+	QVERIFY(!container.isMapped());
+	QVERIFY(!QFile::exists(AnnotationContainer::containerPath(dir.path())));
+	QCOMPARE(container.numRows(), 50);
+	QCOMPARE(container.numKeypoints(), NumKeypoints);
+	QVERIFY(container.exportCSV(dir.filePath("exported.csv")));
+	QCOMPARE(readTestFile(dir.filePath("exported.csv")), csv);
+}
+
+
+void AnnotationContainerTest::roundTripMapped() {
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	TestRows rows = randomRows(NumMappedRows, NumKeypoints, 2);
+	QByteArray csv = formatTestCsv(rows);
+	QVERIFY(writeTestFile(AnnotationContainer::csvPath(dir.path()), csv));
+
+	AnnotationContainer container(dir.path());
+	QVERIFY(container.open(AnnotationContainer::ReadWrite));
+	QVERIFY(container.isMapped());
+	QVERIFY(QFile::exists(AnnotationContainer::containerPath(dir.path())));
+	QVERIFY(container.exportCSV(dir.filePath("exported.csv")));
+	QCOMPARE(readTestFile(dir.filePath("exported.csv")), csv);
+	container.close();
+
+	//Opened from annotations.bin this time
+	QByteArray image = readTestFile(AnnotationContainer::containerPath(dir.path()));
+	AnnotationContainer reopened(dir.path());
+	QVERIFY(reopened.open(AnnotationContainer::ReadOnly));
+	QVERIFY(reopened.isMapped());
+	QCOMPARE(readTestFile(AnnotationContainer::containerPath(dir.path())), image);
+	for (int row = 0; row < NumMappedRows; row += 997) {
+		QCOMPARE(reopened.frameName(row), rows.frameNames[row]);
+		QCOMPARE(reopened.csvRowOffset(row), static_cast<qint64>(csv.indexOf(
+					rows.frameNames[row].toUtf8() + ",")));
+		for (int i = 0; i < NumKeypoints; i++) {
+			QCOMPARE(reopened.states(row)[i], rows.statesRow(row)[i]);
+			if (std::isnan(rows.xRow(row)[i])) {
+				QVERIFY(std::isnan(reopened.x(row)[i]));
+			}
+		}
+	}
+	QVERIFY(reopened.exportCSV(dir.filePath("reexported.csv")));
+	QCOMPARE(readTestFile(dir.filePath("reexported.csv")), csv);
+}
+
+
+void AnnotationContainerTest::staleContainerIsReplaced() {
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	TestRows rows = randomRows(NumMappedRows, NumKeypoints, 3);
+	QVERIFY(writeTestFile(AnnotationContainer::csvPath(dir.path()),
+				formatTestCsv(rows)));
+	AnnotationContainer container(dir.path());
+	QVERIFY(container.open(AnnotationContainer::ReadWrite));
+	container.close();
+
+	//Keeps the old container mapped while it is rebuilt
+	AnnotationContainer reader(dir.path());
+	QVERIFY(reader.open(AnnotationContainer::ReadOnly));
+	QVERIFY(reader.isMapped());
+	std::vector<uint8_t> states(reader.states(0), reader.states(0) + NumKeypoints);
+
+	QByteArray csv = formatTestCsv(randomRows(NumMappedRows + 100, NumKeypoints, 4));
+	QVERIFY(writeTestFile(AnnotationContainer::csvPath(dir.path()), csv));
+	AnnotationContainer rebuilt(dir.path());
+	QVERIFY(rebuilt.open(AnnotationContainer::ReadWrite));
+	QVERIFY(rebuilt.isMapped());
+	QCOMPARE(rebuilt.numRows(), NumMappedRows + 100);
+	QVERIFY(rebuilt.exportCSV(dir.filePath("exported.csv")));
+	QCOMPARE(readTestFile(dir.filePath("exported.csv")), csv);
+
+	//The old file was replaced, not rewritten under the reader
+	QCOMPARE(reader.numRows(), NumMappedRows);
+	QVERIFY(std::equal(states.begin(), states.end(), reader.states(0)));
+}
+
+
+QTEST_GUILESS_MAIN(AnnotationContainerTest)
+#include "annotationcontainertest.moc"
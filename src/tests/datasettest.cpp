@@ -0,0 +1,180 @@
+/*******************************************************************************
+ * File:			  datasettest.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "dataset.hpp"
+#include "testcsv.hpp"
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include <limits>
+
+
+static const int NumRows = 30;
+static const int NumKeypoints = 6;
+static const QList<QString> CameraNames = {"Camera_A", "Camera_B"};
+
+
+// Edits made through the keypoint store have to end up in the csv of their
+// camera after a flush, including reprojections, and edits that only reached
+// the journal are recovered on the next load.
+class DatasetTest : public QObject {
+	Q_OBJECT
+
+	private slots:
+		void init();
+		void cleanup();
+		void editedRowsAreSaved();
+		void reprojectionsAreSaved();
+		void journaledEditsAreRecovered();
+
+	private:
+		QString csvPath(int cam) const {
+			return AnnotationContainer::csvPath(m_segmentFolder + "/" + CameraNames[cam]);
+		}
+		Dataset *loadDataset();
+		//First keypoint in the given state, -1 if there is none
+		static int findKeypoint(const TestRows& rows, KeypointState state);
+
+		QTemporaryDir *m_dir = nullptr;
+		QString m_segmentFolder;
+		QList<TestRows> m_rows;
+};
+
+
+void DatasetTest::init() {
+	m_dir = new QTemporaryDir();
+	QVERIFY(m_dir->isValid());
+	m_segmentFolder = m_dir->filePath("Segment");
+	m_rows.clear();
+	for (int cam = 0; cam < CameraNames.size(); cam++) {
+		//Reprojected keypoints are recalculated on load, the csvs start without
+		m_rows.append(randomRows(NumRows, NumKeypoints, 30 + cam, false));
+		QVERIFY(writeTestFile(csvPath(cam), formatTestCsv(m_rows[cam])));
+	}
+}
+
+
+void DatasetTest::cleanup() {
+	delete m_dir;
+	m_dir = nullptr;
+}
+
+
+Dataset *DatasetTest::loadDataset() {
+	return new Dataset(m_segmentFolder, m_dir->path(), CameraNames);
+}
+
+
+int DatasetTest::findKeypoint(const TestRows& rows, KeypointState state) {
+	for (size_t i = 0; i < rows.states.size(); i++) {
+		if (rows.states[i] == state) return static_cast<int>(i);
+	}
+	return -1;
+}
+
+
+void DatasetTest::editedRowsAreSaved() {
+	QScopedPointer<Dataset> dataset(loadDataset());
+	QVERIFY(dataset->loadSuccessfull());
+	KeypointStore *keypointStore = dataset->keypointStore();
+	QCOMPARE(keypointStore->numImgSets(), NumRows);
+	QByteArray untouchedCSV = readTestFile(csvPath(1));
+
+	TestRows expected = m_rows[0];
+	keypointStore->setCoordinates(4, 0, 2, 321.5f, 654.25f);
+	keypointStore->setState(4, 0, 2, Annotated);
+	expected.setKeypoint(4, 2, 321.5f, 654.25f, Annotated);
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	keypointStore->setState(11, 0, 5, Suppressed);
+	expected.setKeypoint(11, 5, nan, nan, Suppressed);
+
+	dataset->flush();
+	QCOMPARE(readTestFile(csvPath(0)), formatTestCsv(expected));
+	QCOMPARE(readTestFile(csvPath(1)), untouchedCSV);
+	QCOMPARE(QFileInfo(EditJournal::journalPath(m_segmentFolder)).size(),
+				qint64(24));
+
+	//Flushing without edits leaves the csvs alone
+	QDateTime lastModified = QFileInfo(csvPath(0)).lastModified();
+	dataset->flush();
+	QCOMPARE(QFileInfo(csvPath(0)).lastModified(), lastModified);
+}
+
+
+void DatasetTest::reprojectionsAreSaved() {
+	int keypoint = findKeypoint(m_rows[1], NotAnnotated);
+	QVERIFY(keypoint >= 0);
+	const int row = keypoint/NumKeypoints;
+	const int keypointId = keypoint%NumKeypoints;
+
+	QScopedPointer<Dataset> dataset(loadDataset());
+	QVERIFY(dataset->loadSuccessfull());
+	KeypointStore *keypointStore = dataset->keypointStore();
+	QByteArray untouchedCSV = readTestFile(csvPath(0));
+
+	//A change between not annotated and reprojected still dirties its row
+	TestRows expected = m_rows[1];
+	keypointStore->setCoordinates(row, 1, keypointId, 800.75f, 90.5f);
+	keypointStore->setState(row, 1, keypointId, Reprojected);
+	expected.setKeypoint(row, keypointId, 800.75f, 90.5f, Reprojected);
+	dataset->flush();
+	QCOMPARE(readTestFile(csvPath(1)), formatTestCsv(expected));
+	QCOMPARE(readTestFile(csvPath(0)), untouchedCSV);
+
+	keypointStore->setState(row, 1, keypointId, NotAnnotated);
+	dataset->flush();
+	QCOMPARE(readTestFile(csvPath(1)), formatTestCsv(m_rows[1]));
+}
+
+
+void DatasetTest::journaledEditsAreRecovered() {
+	QList<EditJournal::Record> records = {
+		{2, 0, 1, 10.5f, 20.5f, Annotated},
+		{17, 1, 3, 0.0f, 0.0f, Suppressed},
+		{2, 0, 1, 11.5f, 21.5f, Annotated}
+	};
+	{
+		EditJournal journal(m_segmentFolder);
+		QVERIFY(journal.open(NumRows, CameraNames.size(), NumKeypoints));
+		for (const auto& record : records) QVERIFY(journal.append(record));
+	}
+	//The editor crashed while writing the next record
+	QFile file(EditJournal::journalPath(m_segmentFolder));
+	QVERIFY(file.open(QIODevice::Append));
+	QCOMPARE(file.write("\x05\x00\x00\x00\x00\x00\x04\x00", 8), qint64(8));
+	file.close();
+
+	TestRows expected[2] = {m_rows[0], m_rows[1]};
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	expected[0].setKeypoint(2, 1, 11.5f, 21.5f, Annotated);
+	expected[1].setKeypoint(17, 3, nan, nan, Suppressed);
+
+	QScopedPointer<Dataset> dataset(loadDataset());
+	QVERIFY(dataset->loadSuccessfull());
+	KeypointStore *keypointStore = dataset->keypointStore();
+	int idx = keypointStore->index(2, 0, 1);
+	QCOMPARE(keypointStore->state(idx), Annotated);
+	QCOMPARE(keypointStore->x(idx), 11.5f);
+	QCOMPARE(keypointStore->y(idx), 21.5f);
+	QCOMPARE(keypointStore->state(keypointStore->index(17, 1, 3)), Suppressed);
+	//The torn record is dropped, the keypoint keeps its csv state
+	QCOMPARE(static_cast<uint8_t>(keypointStore->state(keypointStore->index(5, 0,
+				4))), m_rows[0].statesRow(5)[4]);
+
+	dataset->flush();
+	QCOMPARE(readTestFile(csvPath(0)), formatTestCsv(expected[0]));
+	QCOMPARE(readTestFile(csvPath(1)), formatTestCsv(expected[1]));
+	QCOMPARE(QFileInfo(EditJournal::journalPath(m_segmentFolder)).size(),
+				qint64(24));
+}
+
+
+QTEST_MAIN(DatasetTest)
+#include "datasettest.moc"
@@ -0,0 +1,202 @@
+/*******************************************************************************
+ * File:			  datasetwritertest.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "datasetwriter.hpp"
+#include "testcsv.hpp"
+
+#include <QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include <limits>
+
+
+static const int NumRows = 40;
+static const int NumKeypoints = 6;
+static const QList<QString> CameraNames = {"Camera_A", "Camera_B"};
+
+
+// Compaction has to rewrite the stored rows of every camera, leave all other
+// rows untouched and keep containers, index and journal in step with the
+// csvs. Interrupted commits are finished or dropped as a whole.
+class DatasetWriterTest : public QObject {
+	Q_OBJECT
+
+	private slots:
+		void init();
+		void cleanup();
+		void compactionRewritesOnlyStoredRows();
+		void interruptedCommitIsFinished();
+		void pendingCsvWithoutMarkerIsDropped();
+
+	private:
+		QString csvPath(int cam) const {
+			return AnnotationContainer::csvPath(m_segmentFolder + "/" + CameraNames[cam]);
+		}
+		DatasetWriter *createWriter();
+		static AnnotationSnapshotPtr snapshot(int cam, const TestRows& rows,
+					const QList<int>& rowIndices);
+
+		QTemporaryDir *m_dir = nullptr;
+		QString m_segmentFolder;
+		QList<TestRows> m_rows;
+		QList<AnnotationContainer*> m_containers;
+		DatasetIndex *m_index = nullptr;
+};
+
+
+void DatasetWriterTest::init() {
+	m_dir = new QTemporaryDir();
+	QVERIFY(m_dir->isValid());
+	m_segmentFolder = m_dir->filePath("Segment");
+	m_rows.clear();
+	for (int cam = 0; cam < CameraNames.size(); cam++) {
+		m_rows.append(randomRows(NumRows, NumKeypoints, 10 + cam));
+		QVERIFY(writeTestFile(csvPath(cam), formatTestCsv(m_rows[cam])));
+		m_containers.append(new AnnotationContainer(m_segmentFolder + "/" +
+					CameraNames[cam]));
+	}
+	QVERIFY(AnnotationContainer::openAll(m_containers,
+				AnnotationContainer::ReadWrite));
+	m_index = new DatasetIndex(m_dir->path(), m_segmentFolder);
+}
+
+
+void DatasetWriterTest::cleanup() {
+	qDeleteAll(m_containers);
+	m_containers.clear();
+	delete m_index;
+	m_index = nullptr;
+	delete m_dir;
+	m_dir = nullptr;
+}
+
+
+DatasetWriter *DatasetWriterTest::createWriter() {
+	QList<QList<QString>> frameNames;
+	QList<QList<qint64>> rowOffsets;
+	for (const auto& container : m_containers) {
+		frameNames.append(QList<QString>());
+		rowOffsets.append(QList<qint64>());
+		for (int row = 0; row < container->numRows(); row++) {
+			frameNames.last().append(container->frameName(row));
+		}
+		for (int row = 0; row <= container->numRows(); row++) {
+			rowOffsets.last().append(container->csvRowOffset(row));
+		}
+	}
+	return new DatasetWriter(m_segmentFolder, CameraNames,
+				testCsvHeader(NumKeypoints), frameNames, NumKeypoints, rowOffsets,
+				m_containers, m_index);
+}
+
+
+AnnotationSnapshotPtr DatasetWriterTest::snapshot(int cam, const TestRows& rows,
+			const QList<int>& rowIndices) {
+	QSharedPointer<AnnotationSnapshot> snapshot =
+				QSharedPointer<AnnotationSnapshot>::create();
+	AnnotationSnapshot::Camera camera;
+	camera.cameraIndex = cam;
+	camera.rows = rowIndices;
+	for (const auto& row : rowIndices) {
+		camera.x.insert(camera.x.end(), rows.xRow(row), rows.xRow(row) + NumKeypoints);
+		camera.y.insert(camera.y.end(), rows.yRow(row), rows.yRow(row) + NumKeypoints);
+		camera.states.insert(camera.states.end(), rows.statesRow(row),
+					rows.statesRow(row) + NumKeypoints);
+	}
+	snapshot->cameras.append(camera);
+	return snapshot;
+}
+
+
+void DatasetWriterTest::compactionRewritesOnlyStoredRows() {
+	QScopedPointer<DatasetWriter> writer(createWriter());
+	QSignalSpy writeFailed(writer.data(), &DatasetWriter::writeFailed);
+	QByteArray originalCSV = readTestFile(csvPath(0));
+	QByteArray untouchedCSV = readTestFile(csvPath(1));
+
+	TestRows expected = m_rows[0];
+	expected.setKeypoint(3, 1, 100.5f, 200.25f, Annotated);
+	expected.setKeypoint(17, 4, 33.5f, 44.75f, Reprojected);
+	writer->appendJournalSlot({3, 0, 1, 100.5f, 200.25f, Annotated});
+	writer->syncJournalSlot();
+	writer->storeSnapshotSlot(snapshot(0, expected, {3, 17}));
+	//Stored rows only reach the csv and the container on compaction
+	QCOMPARE(readTestFile(csvPath(0)), originalCSV);
+	QCOMPARE(m_containers[0]->states(17)[4], m_rows[0].statesRow(17)[4]);
+
+	writer->compactSlot();
+	QCOMPARE(writeFailed.count(), 0);
+	QCOMPARE(readTestFile(csvPath(0)), formatTestCsv(expected));
+	QCOMPARE(readTestFile(csvPath(1)), untouchedCSV);
+	QCOMPARE(m_containers[0]->states(17)[4], static_cast<uint8_t>(Reprojected));
+	QCOMPARE(m_containers[0]->x(3)[1], 100.5f);
+	QVERIFY(!QFile::exists(csvPath(0) + ".pending"));
+	QVERIFY(!QFile::exists(m_segmentFolder + "/annotations.commit"));
+	QCOMPARE(QFileInfo(EditJournal::journalPath(m_segmentFolder)).size(),
+				qint64(24));
+
+	//The index counts what was written
+	QList<DatasetIndex::KeypointCount> counts;
+	int frameCount;
+	QVERIFY(m_index->keypointCounts(CameraNames[0], &counts, &frameCount));
+	QCOMPARE(frameCount, NumRows);
+	QCOMPARE(counts.size(), NumKeypoints);
+	for (int i = 0; i < NumKeypoints; i++) {
+		AnnotationCount count;
+		for (int row = 0; row < NumRows; row++) {
+			uint8_t state = expected.statesRow(row)[i];
+			if (state == Annotated) count.annotated++;
+			else if (state == Reprojected) count.reprojected++;
+			else if (state == NotAnnotated) count.notAnnotated++;
+		}
+		QCOMPARE(counts[i].count.annotated, count.annotated);
+		QCOMPARE(counts[i].count.reprojected, count.reprojected);
+		QCOMPARE(counts[i].count.notAnnotated, count.notAnnotated);
+	}
+
+	//Rows of the rewritten csv are reused by the next compaction
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	expected.setKeypoint(0, 0, nan, nan, Suppressed);
+	writer->storeSnapshotSlot(snapshot(0, expected, {0}));
+	writer->compactSlot();
+	QCOMPARE(writeFailed.count(), 0);
+	QCOMPARE(readTestFile(csvPath(0)), formatTestCsv(expected));
+}
+
+
+void DatasetWriterTest::interruptedCommitIsFinished() {
+	//Camera_B was already renamed when the commit was interrupted
+	QByteArray pendingCSV = formatTestCsv(randomRows(NumRows, NumKeypoints, 20));
+	QVERIFY(writeTestFile(csvPath(0) + ".pending", pendingCSV));
+	QVERIFY(writeTestFile(m_segmentFolder + "/annotations.commit",
+				"Camera_A\nCamera_B\n"));
+	QByteArray untouchedCSV = readTestFile(csvPath(1));
+
+	QVERIFY(DatasetWriter::recoverCommit(m_segmentFolder, CameraNames));
+	QCOMPARE(readTestFile(csvPath(0)), pendingCSV);
+	QCOMPARE(readTestFile(csvPath(1)), untouchedCSV);
+	QVERIFY(!QFile::exists(csvPath(0) + ".pending"));
+	QVERIFY(!QFile::exists(m_segmentFolder + "/annotations.commit"));
+}
+
+
+void DatasetWriterTest::pendingCsvWithoutMarkerIsDropped() {
+	QByteArray originalCSV = readTestFile(csvPath(0));
+	QVERIFY(writeTestFile(csvPath(0) + ".pending",
+				formatTestCsv(randomRows(NumRows, NumKeypoints, 21))));
+
+	QVERIFY(DatasetWriter::recoverCommit(m_segmentFolder, CameraNames));
+	QCOMPARE(readTestFile(csvPath(0)), originalCSV);
+	QVERIFY(!QFile::exists(csvPath(0) + ".pending"));
+}
+
+
+QTEST_GUILESS_MAIN(DatasetWriterTest)
+#include "datasetwritertest.moc"
@@ -0,0 +1,189 @@
+/*******************************************************************************
+ * File:			  editjournaltest.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "editjournal.hpp"
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+
+//Layout of annotations.journal: a 24 byte header followed by 18 byte records
+static const qint64 JournalHeaderSize = 24;
+static const qint64 JournalRecordSize = 18;
+
+
+// Replaying has to restore every complete record and stop at the first one
+// that was torn or corrupted by a crash.
+class EditJournalTest : public QObject {
+	Q_OBJECT
+
+	private slots:
+		void replayRestoresRecords();
+		void tornLastRecordIsDropped();
+		void corruptedRecordEndsReplay();
+		void differentLayoutResetsJournal();
+		void discardKeepsLaterRecords();
+
+	private:
+		static QList<EditJournal::Record> testRecords();
+		static QList<EditJournal::Record> replay(const QString& datasetFolder,
+					int numImgSets = 10, int numCameras = 3, int numKeypoints = 5);
+		static void compareRecords(const QList<EditJournal::Record>& records,
+					const QList<EditJournal::Record>& expected);
+};
+
+
+QList<EditJournal::Record> EditJournalTest::testRecords() {
+	return {
+		{0, 0, 0, 12.5f, 100.25f, Annotated},
+		{9, 2, 4, 1279.0f, 0.5f, Annotated},
+		{3, 1, 2, 0.0f, 0.0f, Suppressed},
+		{3, 1, 2, 640.75f, 512.125f, NotAnnotated}
+	};
+}
+
+
+QList<EditJournal::Record> EditJournalTest::replay(const QString& datasetFolder,
+			int numImgSets, int numCameras, int numKeypoints) {
+	EditJournal journal(datasetFolder);
+	QList<EditJournal::Record> records;
+	if (!journal.open(numImgSets, numCameras, numKeypoints)) return records;
+	journal.replay([&records](const EditJournal::Record& record) {
+		records.append(record);
+	});
+	return records;
+}
+
+
+void EditJournalTest::compareRecords(const QList<EditJournal::Record>& records,
+			const QList<EditJournal::Record>& expected) {
+	QCOMPARE(records.size(), expected.size());
+	for (int i = 0; i < records.size(); i++) {
+		QCOMPARE(records[i].imgSetIndex, expected[i].imgSetIndex);
+		QCOMPARE(records[i].frameIndex, expected[i].frameIndex);
+		QCOMPARE(records[i].keypointId, expected[i].keypointId);
+		QCOMPARE(records[i].x, expected[i].x);
+		QCOMPARE(records[i].y, expected[i].y);
+		QCOMPARE(records[i].state, expected[i].state);
+	}
+}
+
+
+void EditJournalTest::replayRestoresRecords() {
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	{
+		EditJournal journal(dir.path());
+		QVERIFY(journal.open(10, 3, 5));
+		QVERIFY(journal.isEmpty());
+		for (const auto& record : testRecords()) {
+			QVERIFY(journal.append(record));
+		}
+		QCOMPARE(journal.position(), 4*JournalRecordSize);
+	}
+	compareRecords(replay(dir.path()), testRecords());
+}
+
+
+void EditJournalTest::tornLastRecordIsDropped() {
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	QList<EditJournal::Record> records = testRecords();
+	{
+		EditJournal journal(dir.path());
+		QVERIFY(journal.open(10, 3, 5));
+		for (int i = 0; i < 3; i++) QVERIFY(journal.append(records[i]));
+	}
+	//A crash in the middle of writing the fourth record
+	QFile file(EditJournal::journalPath(dir.path()));
+	QVERIFY(file.open(QIODevice::Append));
+	QCOMPARE(file.write("\x03\x00\x00\x00\x01\x00\x02", 7), qint64(7));
+	file.close();
+
+	compareRecords(replay(dir.path()), records.mid(0, 3));
+	QCOMPARE(QFileInfo(file.fileName()).size(),
+				JournalHeaderSize + 3*JournalRecordSize);
+
+	//New records are appended behind the valid ones
+	{
+		EditJournal journal(dir.path());
+		QVERIFY(journal.open(10, 3, 5));
+		QVERIFY(journal.append(records[3]));
+	}
+	compareRecords(replay(dir.path()), records);
+}
+
+
+void EditJournalTest::corruptedRecordEndsReplay() {
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	{
+		EditJournal journal(dir.path());
+		QVERIFY(journal.open(10, 3, 5));
+		for (const auto& record : testRecords()) QVERIFY(journal.append(record));
+	}
+	//Flips a coordinate byte of the second record
+	QFile file(EditJournal::journalPath(dir.path()));
+	QVERIFY(file.open(QIODevice::ReadWrite));
+	QVERIFY(file.seek(JournalHeaderSize + JournalRecordSize + 9));
+	char byte;
+	QVERIFY(file.getChar(&byte));
+	QVERIFY(file.seek(JournalHeaderSize + JournalRecordSize + 9));
+	QVERIFY(file.putChar(static_cast<char>(byte ^ 0x40)));
+	file.close();
+
+	compareRecords(replay(dir.path()), testRecords().mid(0, 1));
+}
+
+
+void EditJournalTest::differentLayoutResetsJournal() {
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	{
+		EditJournal journal(dir.path());
+		QVERIFY(journal.open(10, 3, 5));
+		for (const auto& record : testRecords()) QVERIFY(journal.append(record));
+	}
+	//Records of a segment with a different number of keypoints
+	QVERIFY(replay(dir.path(), 10, 3, 6).isEmpty());
+	QCOMPARE(QFileInfo(EditJournal::journalPath(dir.path())).size(),
+				JournalHeaderSize);
+}
+
+
+void EditJournalTest::discardKeepsLaterRecords() {
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	QList<EditJournal::Record> records = testRecords();
+	{
+		EditJournal journal(dir.path());
+		QVERIFY(journal.open(10, 3, 5));
+		QVERIFY(journal.append(records[0]));
+		QVERIFY(journal.append(records[1]));
+		qint64 position = journal.position();
+		QVERIFY(journal.append(records[2]));
+		QVERIFY(journal.append(records[3]));
+		QVERIFY(journal.discard(position));
+		//Positions are logical and survive the discard
+		QCOMPARE(journal.position(), 4*JournalRecordSize);
+	}
+	compareRecords(replay(dir.path()), records.mid(2));
+	{
+		EditJournal journal(dir.path());
+		QVERIFY(journal.open(10, 3, 5));
+		QVERIFY(journal.discard(journal.position()));
+		QVERIFY(journal.isEmpty());
+		QVERIFY(journal.append(records[1]));
+	}
+	compareRecords(replay(dir.path()), records.mid(1, 1));
+}
+
+
+QTEST_GUILESS_MAIN(EditJournalTest)
+#include "editjournaltest.moc"
@@ -0,0 +1,204 @@
+/*******************************************************************************
+ * File:			  reprojectiontooltest.cpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#include "reprojectiontool.hpp"
+
+#include <QtTest>
+
+#include <opencv2/calib3d.hpp>
+
+#include <random>
+
+
+static const QList<QString> CameraNames = {"Camera_B", "Camera_L", "Camera_R",
+			"Camera_T"};
+static const int NumCameras = 4;
+static const int NumPoints = 200;
+
+
+// The batch projection and triangulation have to agree with OpenCV's
+// cv::projectPoints and cv::triangulatePoints on a calibration in the format
+// written by the calibration tool.
+class ReprojectionToolTest : public QObject {
+	Q_OBJECT
+
+	private slots:
+		void initTestCase();
+		void cleanupTestCase();
+		void projectionMatchesProjectPoints();
+		void reconstructionMatchesTriangulatePoints();
+		void pointsNeedTwoViews();
+		void robustReconstructionDropsOutliers();
+
+	private:
+		//K, R and t in OpenCV's convention, the files store K and R transposed
+		void cameraMatrices(int cam, cv::Mat& K, cv::Mat& R, cv::Mat& t) const;
+		//Ground truth points in front of all cameras and their projections with
+		//cv::projectPoints, numPoints x numCameras CV_64FC2
+		void opencvProjections(const cv::Mat& points3D, cv::Mat& projected) const;
+
+		ReprojectionTool *m_reprojectionTool = nullptr;
+		cv::Mat m_points3D;
+};
+
+
+void ReprojectionToolTest::initTestCase() {
+	QList<QString> paths;
+	for (const auto& cameraName : CameraNames) {
+		paths.append(QString(TEST_DATA_DIR) + "/calibration/" + cameraName + ".yaml");
+		QVERIFY(QFile::exists(paths.last()));
+	}
+	m_reprojectionTool = new ReprojectionTool(paths, paths, 0);
+	QCOMPARE(m_reprojectionTool->cameraNames(), CameraNames);
+
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<double> coordinate(-120.0, 120.0);
+	m_points3D.create(NumPoints, 3, CV_64F);
+	for (int i = 0; i < NumPoints; i++) {
+		for (int j = 0; j < 3; j++) m_points3D.at<double>(i,j) = coordinate(generator);
+	}
+}
+
+
+void ReprojectionToolTest::cleanupTestCase() {
+	delete m_reprojectionTool;
+}
+
+
+void ReprojectionToolTest::cameraMatrices(int cam, cv::Mat& K, cv::Mat& R,
+			cv::Mat& t) const {
+	K = m_reprojectionTool->intrinsicsList()[cam].intrinsicMatrix.t();
+	R = m_reprojectionTool->extrinsicsList()[cam].rotationMatrix.t();
+	t = m_reprojectionTool->extrinsicsList()[cam].translationVector.reshape(1, 3);
+}
+
+
+void ReprojectionToolTest::opencvProjections(const cv::Mat& points3D,
+			cv::Mat& projected) const {
+	projected.create(points3D.rows, NumCameras, CV_64FC2);
+	for (int cam = 0; cam < NumCameras; cam++) {
+		cv::Mat K, R, t, rvec;
+		cameraMatrices(cam, K, R, t);
+		cv::Rodrigues(R, rvec);
+		std::vector<cv::Point2d> imagePoints;
+		cv::projectPoints(points3D.reshape(3), rvec, t, K,
+					m_reprojectionTool->intrinsicsList()[cam].distortionCoefficients,
+					imagePoints);
+		for (int i = 0; i < points3D.rows; i++) {
+			projected.at<cv::Vec2d>(i, cam) = cv::Vec2d(imagePoints[i].x,
+						imagePoints[i].y);
+		}
+	}
+}
+
+
+void ReprojectionToolTest::projectionMatchesProjectPoints() {
+	cv::Mat expected, projected;
+	opencvProjections(m_points3D, expected);
+	m_reprojectionTool->projectPoints(m_points3D, projected);
+	QCOMPARE(projected.rows, NumPoints);
+	QCOMPARE(projected.cols, NumCameras);
+	QVERIFY(cv::norm(projected, expected, cv::NORM_INF) < 1e-6);
+
+	//The single point interface uses the same projection
+	QList<QPointF> reprojected = m_reprojectionTool->reprojectPoint(
+				m_points3D.row(0).t());
+	for (int cam = 0; cam < NumCameras; cam++) {
+		cv::Vec2d p = expected.at<cv::Vec2d>(0, cam);
+		QVERIFY(std::abs(reprojected[cam].x() - p[0]) < 1e-6);
+		QVERIFY(std::abs(reprojected[cam].y() - p[1]) < 1e-6);
+	}
+}
+
+
+void ReprojectionToolTest::reconstructionMatchesTriangulatePoints() {
+	cv::Mat projected;
+	opencvProjections(m_points3D, projected);
+	cv::Mat valid = cv::Mat::ones(NumPoints, NumCameras, CV_8U);
+	cv::Mat points3D, reconstructed;
+	m_reprojectionTool->reconstructPoints3D(projected, valid, points3D,
+				reconstructed);
+	QCOMPARE(cv::countNonZero(reconstructed), NumPoints);
+	QVERIFY(cv::norm(points3D, m_points3D, cv::NORM_INF) < 1e-4);
+
+	//cv::triangulatePoints on the undistorted points of the first two cameras
+	cv::Mat projectionMatrices[2];
+	cv::Mat undistorted[2];
+	for (int cam = 0; cam < 2; cam++) {
+		cv::Mat K, R, t;
+		cameraMatrices(cam, K, R, t);
+		cv::Mat Rt;
+		cv::hconcat(R, t, Rt);
+		projectionMatrices[cam] = K*Rt;
+		std::vector<cv::Point2d> imagePoints, undistortedPoints;
+		for (int i = 0; i < NumPoints; i++) {
+			cv::Vec2d p = projected.at<cv::Vec2d>(i, cam);
+			imagePoints.push_back(cv::Point2d(p[0], p[1]));
+		}
+		cv::undistortPoints(imagePoints, undistortedPoints, K,
+					m_reprojectionTool->intrinsicsList()[cam].distortionCoefficients,
+					cv::noArray(), K);
+		undistorted[cam] = cv::Mat(undistortedPoints, true).reshape(1,
+					NumPoints).t();
+	}
+	cv::Mat homogeneous;
+	cv::triangulatePoints(projectionMatrices[0], projectionMatrices[1],
+				undistorted[0], undistorted[1], homogeneous);
+	for (int i = 0; i < NumPoints; i++) {
+		double w = homogeneous.at<double>(3,i);
+		for (int j = 0; j < 3; j++) {
+			//cv::undistortPoints stops after five iterations, so the two view
+			//result is only close to the ground truth
+			QVERIFY(std::abs(homogeneous.at<double>(j,i)/w -
+						points3D.at<double>(i,j)) < 0.1);
+		}
+	}
+}
+
+
+void ReprojectionToolTest::pointsNeedTwoViews() {
+	cv::Mat projected;
+	opencvProjections(m_points3D.rowRange(0, 3), projected);
+	cv::Mat valid = cv::Mat::zeros(3, NumCameras, CV_8U);
+	valid.at<uchar>(0,2) = 1;
+	valid.at<uchar>(1,1) = 1;
+	valid.at<uchar>(1,3) = 1;
+	cv::Mat points3D, reconstructed;
+	m_reprojectionTool->reconstructPoints3D(projected, valid, points3D,
+				reconstructed);
+	QCOMPARE(reconstructed.at<uchar>(0), uchar(0));
+	QCOMPARE(reconstructed.at<uchar>(1), uchar(1));
+	QCOMPARE(reconstructed.at<uchar>(2), uchar(0));
+	QVERIFY(cv::norm(points3D.row(1), m_points3D.row(1), cv::NORM_INF) < 1e-4);
+}
+
+
+void ReprojectionToolTest::robustReconstructionDropsOutliers() {
+	cv::Mat projected;
+	opencvProjections(m_points3D, projected);
+	//Every point has one view that is 40 pixels off
+	for (int i = 0; i < NumPoints; i++) {
+		projected.at<cv::Vec2d>(i, i % NumCameras) += cv::Vec2d(40.0, -25.0);
+	}
+	cv::Mat valid = cv::Mat::ones(NumPoints, NumCameras, CV_8U);
+	cv::Mat points3D, reconstructed, inliers;
+	m_reprojectionTool->reconstructPoints3DRobust(projected, valid, 5.0, points3D,
+				reconstructed, inliers);
+	QCOMPARE(cv::countNonZero(reconstructed), NumPoints);
+	for (int i = 0; i < NumPoints; i++) {
+		for (int cam = 0; cam < NumCameras; cam++) {
+			QCOMPARE(inliers.at<uchar>(i, cam), uchar(cam != i % NumCameras));
+		}
+	}
+	QVERIFY(cv::norm(points3D, m_points3D, cv::NORM_INF) < 1e-4);
+}
+
+
+QTEST_GUILESS_MAIN(ReprojectionToolTest)
+#include "reprojectiontooltest.moc"
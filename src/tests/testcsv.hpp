@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * File:			  testcsv.hpp
+ * Created: 	  16. October 2026
+ * Author:		  agent
+ * Contact: 	  agent@local
+ * Copyright:   2022 Timo Hueser
+ * License:     LGPL v2.1
+ ******************************************************************************/
+
+#ifndef TESTCSV_H
+#define TESTCSV_H
+
+#include "annotationcontainer.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <limits>
+#include <random>
+#include <vector>
+
+
+// Annotation csvs with random contents in the layout written by the
+// annotation tool, shared by the tests that read or write them.
+struct TestRows {
+	int numKeypoints = 0;
+	QList<QString> frameNames;
+	std::vector<float> x;				//[row][keypoint]
+	std::vector<float> y;
+	std::vector<uint8_t> states;
+
+	int numRows() const {return frameNames.size();}
+	const float *xRow(int row) const {return x.data() + row*numKeypoints;}
+	const float *yRow(int row) const {return y.data() + row*numKeypoints;}
+	const uint8_t *statesRow(int row) const {return states.data() + row*numKeypoints;}
+	void setKeypoint(int row, int keypoint, float newX, float newY,
+				KeypointState state) {
+		x[row*numKeypoints + keypoint] = newX;
+		y[row*numKeypoints + keypoint] = newY;
+		states[row*numKeypoints + keypoint] = state;
+	}
+};
+
+
+inline TestRows randomRows(int numRows, int numKeypoints, quint32 seed,
+			bool withReprojected = true) {
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<float> coordinate(0.0f, 1280.0f);
+	std::uniform_int_distribution<int> state(0, withReprojected ? 3 : 2);
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	TestRows rows;
+	rows.numKeypoints = numKeypoints;
+	for (int row = 0; row < numRows; row++) {
+		rows.frameNames.append(QString("Frame_%1.jpg").arg(row));
+		for (int i = 0; i < numKeypoints; i++) {
+			int keypointState = state(generator);
+			//Without reprojections the states are NotAnnotated, Annotated and
+			//Suppressed
+			if (!withReprojected && keypointState == 2) keypointState = Suppressed;
+			bool hasCoordinates = keypointState == Annotated ||
+						keypointState == Reprojected;
+			rows.x.push_back(hasCoordinates ? coordinate(generator) : nan);
+			rows.y.push_back(hasCoordinates ? coordinate(generator) : nan);
+			rows.states.push_back(static_cast<uint8_t>(keypointState));
+		}
+	}
+	return rows;
+}
+
+
+inline QByteArray testCsvHeader(int numKeypoints) {
+	QByteArray header = "Scorer";
+	for (int i = 0; i < numKeypoints*3; i++) header += ",Tester";
+	header += "\nentities";
+	for (int i = 0; i < numKeypoints*3; i++) {
+		header += "," + QByteArray::number(i/3 % 2 ? 1 : 0).prepend("Entity_");
+	}
+	header += "\nbodyparts";
+	for (int i = 0; i < numKeypoints*3; i++) {
+		header += "," + QByteArray::number(i/6).prepend("Bodypart_");
+	}
+	header += "\ncoords";
+	for (int i = 0; i < numKeypoints*3; i++) {
+		if (i%3 == 0) header += ",x";
+		else if (i%3 == 1) header += ",y";
+		else header += ",state";
+	}
+	header += "\n";
+	return header;
+}
+
+
+inline QByteArray formatTestCsv(const TestRows& rows) {
+	QByteArray csv = testCsvHeader(rows.numKeypoints);
+	for (int row = 0; row < rows.numRows(); row++) {
+		csv += AnnotationContainer::formatRow(rows.frameNames[row], rows.xRow(row),
+					rows.yRow(row), rows.statesRow(row), rows.numKeypoints);
+	}
+	return csv;
+}
+
+
+inline bool writeTestFile(const QString& path, const QByteArray& data) {
+	QDir().mkpath(QFileInfo(path).absolutePath());
+	QFile file(path);
+	return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+
+inline QByteArray readTestFile(const QString& path) {
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+	return file.readAll();
+}
+
+#endif
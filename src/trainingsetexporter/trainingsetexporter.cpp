@@ -8,12 +8,14 @@
  ******************************************************************************/
 
 #include "trainingsetexporter.hpp"
+#include "annotationcontainer.hpp"
 #include <fstream>
 #include <iomanip>
 
 #include <algorithm>
 #include <random>
 #include <chrono>
+#include <cmath>
 
 #include <QFile>
 #include <QDir>
@@ -221,38 +223,38 @@ QList<ExportFrameSet> TrainingSetExporter::loadAllFrameSets(
 							QDir::AllDirs | QDir::NoDotAndDotDot);
 				for (const auto & camera : cameras) {
 					QList<QPair<QString,QList<ExportKeypoint>>> framesList;
-					QFile *file = new QFile(exportItem.basePath + "/" + subSet.first + "/"
-								+ camera + "/annotations.csv");
-					if (!file->open(QIODevice::ReadOnly)) {
+					AnnotationContainer container(exportItem.basePath + "/" +
+								subSet.first + "/" + camera);
+					if (!container.open(AnnotationContainer::ReadOnly)) {
 						std::cout << (exportItem.basePath + "/" + subSet.first + "/" +
 									camera + "/annotations.csv").toStdString() << std::endl;
 						std::cout << "Error reading file!" << std::endl;
 					}
 					else {
-						file->readLine(); //Scorer
-						QList<QByteArray> entityNames = file->readLine().split(',');
-						QList<QByteArray> keypointNames = file->readLine().split(',');
-						file->readLine(); //Coords
-						while (!file->atEnd()) {
-							QList<QByteArray> cells = file->readLine().split(',');
+						QList<int> exportedKeypoints;
+						for (int i = 0; i < container.numKeypoints(); i++) {
+							if (entitiesSaveMap[container.entity(i)] &&
+										keypointsSaveMap[container.bodypart(i)]) {
+								exportedKeypoints.append(i);
+							}
+						}
+						for (int row = 0; row < container.numRows(); row++) {
+							const float *xs = container.x(row);
+							const float *ys = container.y(row);
+							const uint8_t *states = container.states(row);
 							QPair<QString,QList<ExportKeypoint>> keypoints;
-							keypoints.first = cells[0];
-							for (int i = 1; i < cells.size()-2; i += 3) {
-								if (entitiesSaveMap[entityNames[i]] &&
-											keypointsSaveMap[keypointNames[i]]) {
-									ExportKeypoint keypoint;
-									keypoint.point = QPointF(cells[i].toFloat(),
-												cells[i+1].toFloat());
-									keypoint.state = static_cast<KeypointState>(
-												cells[i+2].toInt());
-									keypoints.second.append(keypoint);
-								}
+							keypoints.first = container.frameName(row);
+							for (const auto& i : exportedKeypoints) {
+								ExportKeypoint keypoint;
+								keypoint.point = QPointF(std::isnan(xs[i]) ? 0.0f : xs[i],
+											std::isnan(ys[i]) ? 0.0f : ys[i]);
+								keypoint.state = static_cast<KeypointState>(states[i]);
+								keypoints.second.append(keypoint);
 							}
 							framesList.append(keypoints);
 						}
 						keypointsMap[camera] = framesList;
 					}
-					file->close();
 				}
 				for (int i = 0; i < keypointsMap[cameras[0]].size(); i++) {
 					ExportFrameSet frameSet;